@@ -1,4 +1,5 @@
 #include "celltower.h"
+#include "timeline.h"
 #include <algorithm>
 #include <iostream>
 #include <iomanip>
@@ -35,10 +36,16 @@ int CellTower::totalCapacity() const{
 }
 
 void CellTower::allocate(std::vector<Subscriber> &subs, const std::string &strategy){
+    TIMELINE_SCOPE("allocate", "allocate");
     std::lock_guard<std::mutex> lk(mtx_);
     allocations_.clear();
+    // Every call is a fresh allocation: users blocked last time get another chance
+    for (auto &s : subs){ s.dropped = false; s.assigned_channel = -1; }
     int ch = channels();
-    if (ch <= 0) return;
+    if (ch <= 0){
+        for (auto &s : subs) s.dropped = true;
+        return;
+    }
     
     allocations_.resize(ch);
     int per = usersPerChannel();
@@ -49,7 +56,6 @@ void CellTower::allocate(std::vector<Subscriber> &subs, const std::string &strat
     if (strategy == "round_robin"){
         int idx = 0;
         for (auto &s : subs){
-            if (s.dropped) continue;
             bool placed = false;
             for (int k=0; k<ch; k++){
                 int i = (idx + k) % ch;
@@ -66,7 +72,6 @@ void CellTower::allocate(std::vector<Subscriber> &subs, const std::string &strat
     } else { // best_fit
         int cur = 0;
         for (auto &s : subs){
-            if (s.dropped) continue;
             while (cur < ch && (int)allocations_[cur].size() >= per) cur++;
             if (cur >= ch){ s.dropped = true; s.assigned_channel = -1; continue; }
             allocations_[cur].push_back(s.id);
@@ -75,6 +80,14 @@ void CellTower::allocate(std::vector<Subscriber> &subs, const std::string &strat
     }
 }
 
+void CellTower::release(int userId, int ch){
+    std::lock_guard<std::mutex> lk(mtx_);
+    if (ch < 1 || ch > (int)allocations_.size()) return;
+    auto &slot = allocations_[ch-1];
+    auto it = std::find(slot.begin(), slot.end(), userId);
+    if (it != slot.end()) slot.erase(it);
+}
+
 std::vector<int> CellTower::usersInChannel(int ch) const{
     std::lock_guard<std::mutex> lk(mtx_);
     if (ch < 1 || ch > (int)allocations_.size()) return {};
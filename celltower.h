@@ -17,6 +17,8 @@ public:
     int totalCapacity() const;
     
     void allocate(std::vector<Subscriber> &subs, const std::string &strategy);
+    // Frees a user's slot after deletion (ch is 1-based, as in assigned_channel)
+    void release(int userId, int ch);
     std::vector<int> usersInChannel(int ch) const;
     int channelsUsed() const;
 
@@ -5,8 +5,8 @@ public:
     CellularCore(int overhead_per_100=10, int core_capacity_msgs=500);
     void setOverheadPer100(int v);
     void setCoreCapacity(int v);
-    int overheadFor(int messages) const;
-    int coresNeeded(int messages) const;
+    long overheadFor(long messages) const;
+    int coresNeeded(long messages) const;
 private:
     int overhead_per_100_;
     int core_capacity_msgs_;
@@ -0,0 +1,185 @@
+#include "generator.h"
+#include "technology.h"
+#include "utils.h"
+#include "timeline.h"
+
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <random>
+#include <memory>
+#include <algorithm>
+#include <climits>
+
+static const long GEN_CHUNK = 64 * 1024;
+static const char *GEN_TECHS[4] = {"2G", "3G", "4G", "5G"};
+static const char *GEN_TYPES[3] = {"data", "voice", "both"};
+static const char *GEN_NAMES[16] = {
+    "Alice", "Bob", "Charlie", "David", "Eve", "Frank", "Grace", "Heidi",
+    "Ivan", "Judy", "Mallory", "Nina", "Oscar", "Peggy", "Rupert", "Sybil"
+};
+
+// SplitMix64 finaliser: decorrelates per-chunk seeds
+static uint64_t mixSeed(uint64_t x){
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+static void parseWeights(const std::string &val, const char **labels, int n, double *out){
+    std::fill(out, out + n, 0.0);
+    std::stringstream ss(val);
+    std::string segment;
+    while (std::getline(ss, segment, ',')){
+        auto c = segment.find(':');
+        if (c == std::string::npos) throw InputError("Expected label:weight, got " + segment);
+        std::string k = trim(segment.substr(0, c));
+        int idx = -1;
+        for (int i = 0; i < n; ++i) if (k == labels[i]) idx = i;
+        if (idx < 0) throw InputError("Unknown mix label: " + k);
+        out[idx] = to_double(trim(segment.substr(c + 1)));
+        if (out[idx] < 0.0) throw InputError("Mix weight cannot be negative: " + segment);
+    }
+}
+
+WorkloadGenerator::WorkloadGenerator(const GeneratorConfig &cfg) : cfg_(cfg) {
+    if (cfg_.count < 0) throw InputError("Generator count cannot be negative");
+    if (cfg_.count > INT_MAX) throw InputError("Generator count exceeds the subscriber id range");
+    if (cfg_.msg_dist != "uniform" && cfg_.msg_dist != "poisson")
+        throw InputError("Unknown message distribution: " + cfg_.msg_dist);
+    if (cfg_.msg_dist == "poisson" && cfg_.msg_mean <= 0.0)
+        throw InputError("Poisson mean must be positive");
+    double tsum = 0.0, ysum = 0.0;
+    for (double w : cfg_.tech_mix) tsum += w;
+    for (double w : cfg_.type_mix) ysum += w;
+    if (tsum <= 0.0 || ysum <= 0.0) throw InputError("Generator mix weights must not all be zero");
+}
+
+GeneratorConfig WorkloadGenerator::loadSpec(const std::string &path){
+    std::ifstream f(path);
+    if (!f) throw InputError("Cannot open generator spec: " + path);
+    GeneratorConfig cfg;
+    std::string line;
+    while (std::getline(f, line)){
+        line = trim(line);
+        if (line.empty() || line[0] == '#') continue;
+        auto eq = line.find('=');
+        if (eq == std::string::npos) continue;
+        std::string key = trim(line.substr(0, eq));
+        std::string val = trim(line.substr(eq + 1));
+
+        if (key == "gen_count") cfg.count = to_long(val);
+        else if (key == "gen_seed") cfg.seed = to_u64(val);
+        else if (key == "gen_tech_mix") parseWeights(val, GEN_TECHS, 4, cfg.tech_mix);
+        else if (key == "gen_type_mix") parseWeights(val, GEN_TYPES, 3, cfg.type_mix);
+        else if (key == "gen_msg_dist") cfg.msg_dist = val;
+        else if (key == "gen_msg_mean") cfg.msg_mean = to_double(val);
+        else if (key == "gen_threads") cfg.threads = to_int(val);
+    }
+    return cfg;
+}
+
+int WorkloadGenerator::workerCount() const {
+    int n = cfg_.threads > 0 ? cfg_.threads : (int)std::thread::hardware_concurrency();
+    return std::max(1, n);
+}
+
+void WorkloadGenerator::fillChunk(Subscriber *dst, long begin, long end, int first_id) const {
+    TIMELINE_SCOPE("generate chunk", "generate");
+    std::shared_ptr<Technology> techs[4] = {
+        std::make_shared<TwoG>(), std::make_shared<ThreeG>(),
+        std::make_shared<FourG>(), std::make_shared<FiveG>()
+    };
+    std::mt19937_64 rng(mixSeed(cfg_.seed ^ mixSeed((uint64_t)(begin / GEN_CHUNK))));
+    std::discrete_distribution<int> pickTech(cfg_.tech_mix, cfg_.tech_mix + 4);
+
+    // Restrict each technology's type pick to the types it accepts (2G has no "both")
+    std::discrete_distribution<int> pickType[4];
+    int limit[4][3];
+    for (int t = 0; t < 4; ++t){
+        double w[3];
+        for (int y = 0; y < 3; ++y){
+            limit[t][y] = techs[t]->max_messages(GEN_TYPES[y]);
+            w[y] = limit[t][y] > 0 ? cfg_.type_mix[y] : 0.0;
+        }
+        if (w[0] + w[1] + w[2] <= 0.0) w[0] = 1.0;
+        pickType[t] = std::discrete_distribution<int>(w, w + 3);
+    }
+    std::poisson_distribution<int> poisson(cfg_.msg_dist == "poisson" ? cfg_.msg_mean : 1.0);
+
+    for (long i = begin; i < end; ++i){
+        Subscriber &s = dst[i - begin];
+        int t = pickTech(rng);
+        int y = pickType[t](rng);
+        int lim = limit[t][y];
+
+        s.id = first_id + (int)i;
+        s.tech = GEN_TECHS[t];
+        s.type = GEN_TYPES[y];
+        if (cfg_.msg_dist == "poisson") s.messages = std::min(lim, std::max(1, poisson(rng)));
+        else s.messages = 1 + (int)(rng() % (uint64_t)lim);
+
+        // Letters-only name: base name + base-26 encoding of the index keeps names unique
+        s.name = GEN_NAMES[rng() % 16];
+        long n = i;
+        do { s.name += (char)('a' + n % 26); n /= 26; } while (n > 0);
+
+        // 10-digit mobile number derived from the id, so repeated runs in one
+        // session don't collide in the registry's phone index
+        std::string digits = std::to_string(s.id % 1000000000L);
+        s.phone = std::string(1, (char)('6' + rng() % 4)) + std::string(9 - digits.size(), '0') + digits;
+
+        s.assigned_channel = -1;
+        s.dropped = false;
+    }
+}
+
+void WorkloadGenerator::generate(std::vector<Subscriber> &out, int first_id) const {
+    out.resize(cfg_.count);
+    long chunks = (cfg_.count + GEN_CHUNK - 1) / GEN_CHUNK;
+    int workers = (int)std::min<long>(workerCount(), std::max(1L, chunks));
+
+    std::vector<std::thread> pool;
+    for (int w = 0; w < workers; ++w){
+        pool.emplace_back([&, w](){
+            for (long c = w; c < chunks; c += workers){
+                long b = c * GEN_CHUNK, e = std::min(cfg_.count, b + GEN_CHUNK);
+                fillChunk(out.data() + b, b, e, first_id);
+            }
+        });
+    }
+    for (auto &t : pool) t.join();
+}
+
+void WorkloadGenerator::writeUsers(const std::string &path, int first_id) const {
+    std::ofstream f(path, std::ios::app);
+    if (!f) throw InputError("Cannot write workload file: " + path);
+
+    long chunks = (cfg_.count + GEN_CHUNK - 1) / GEN_CHUNK;
+    int workers = workerCount();
+
+    // Each round formats one chunk per worker, then writes them in order,
+    // so memory stays at workers x chunk regardless of count.
+    for (long round = 0; round < chunks; round += workers){
+        long inRound = std::min<long>(workers, chunks - round);
+        std::vector<std::string> text(inRound);
+        std::vector<std::thread> pool;
+        for (long k = 0; k < inRound; ++k){
+            pool.emplace_back([&, k](){
+                long b = (round + k) * GEN_CHUNK, e = std::min(cfg_.count, b + GEN_CHUNK);
+                std::vector<Subscriber> subs(e - b);
+                fillChunk(subs.data(), b, e, first_id);
+                std::string &out = text[k];
+                out.reserve(subs.size() * 64);
+                for (const auto &s : subs){
+                    out += "user" + std::to_string(s.id) + "=name:" + s.name + ",phone:" + s.phone
+                         + ",type:" + s.type + ",msg:" + std::to_string(s.messages)
+                         + ",tech:" + s.tech + "\n";
+                }
+            });
+        }
+        for (auto &t : pool) t.join();
+        for (const auto &t : text) f << t;
+    }
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <cstdint>
+#include "subscriber.h"
+
+// Knobs for a synthetic workload. Weights need not sum to 1.
+struct GeneratorConfig {
+    long count = 1000;
+    uint64_t seed = 1;
+    double tech_mix[4] = {0.1, 0.2, 0.4, 0.3};   // 2G, 3G, 4G, 5G
+    double type_mix[3] = {0.6, 0.3, 0.1};        // data, voice, both
+    std::string msg_dist = "uniform";            // "uniform" (1..limit) or "poisson"
+    double msg_mean = 5.0;                       // poisson mean
+    int threads = 0;                             // 0 = hardware concurrency
+};
+
+// Creates valid subscribers in parallel. Work is split into fixed-size chunks,
+// each with its own RNG seeded from (seed, chunk), so output is identical for a
+// given seed regardless of thread count.
+class WorkloadGenerator {
+public:
+    explicit WorkloadGenerator(const GeneratorConfig &cfg);
+
+    // Reads gen_* keys from a config file, leaving other keys to the simulator.
+    static GeneratorConfig loadSpec(const std::string &path);
+
+    // Fills out[0..count) with ids starting at first_id.
+    void generate(std::vector<Subscriber> &out, int first_id) const;
+
+    // Streams USER lines to `path` (appending) without holding the whole roster.
+    void writeUsers(const std::string &path, int first_id) const;
+
+private:
+    void fillChunk(Subscriber *dst, long begin, long end, int first_id) const;
+    int workerCount() const;
+
+    GeneratorConfig cfg_;
+};
@@ -0,0 +1,310 @@
+#include "headless.h"
+#include "simulator.h"
+#include "utils.h"
+
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cstring>
+#include <cerrno>
+#include <cmath>
+#include <climits>
+
+HeadlessController::HeadlessController(Simulator &sim)
+: sim_(sim), last_run_(), shutdown_(false) {}
+
+// --- DISPATCH ---
+
+std::string HeadlessController::handle(const std::string &line){
+    std::string seq;
+    try {
+        JsonValue req = parseJson(line);
+        if (req.type != JsonValue::Object) throw InputError("Command must be a JSON object");
+        if (const JsonValue *s = req.get("seq")){
+            if (s->type == JsonValue::String) seq = ",\"seq\":\"" + jsonEscape(s->str) + "\"";
+            else if (s->type == JsonValue::Number){
+                // Whole numbers round-trip exactly; anything else keeps full precision
+                std::ostringstream o;
+                o << ",\"seq\":";
+                if (s->number == std::floor(s->number) && std::fabs(s->number) < 9.0e15) o << (long long)s->number;
+                else o << std::setprecision(17) << s->number;
+                seq = o.str();
+            }
+        }
+
+        std::string cmd = req.getString("cmd");
+        std::string body;
+        if (cmd == "configure") body = cmdConfigure(req);
+        else if (cmd == "add") body = cmdAdd(req);
+        else if (cmd == "edit") body = cmdEdit(req);
+        else if (cmd == "delete") body = cmdDelete(req);
+        else if (cmd == "run") body = cmdRun();
+        else if (cmd == "stats") body = cmdStats();
+        else if (cmd == "shutdown") shutdown_ = true;
+        else throw InputError("Unknown command: " + cmd);
+        return "{\"ok\":true" + seq + body + "}";
+    } catch (const std::exception &e){
+        return "{\"ok\":false" + seq + ",\"error\":\"" + jsonEscape(e.what()) + "\"}";
+    }
+}
+
+void HeadlessController::serve(std::istream &in, std::ostream &out){
+    std::string line;
+    while (!shutdown_ && std::getline(in, line)){
+        if (trim(line).empty()) continue;
+        out << handle(line) << "\n" << std::flush;
+    }
+}
+
+// MSG_NOSIGNAL: a client that hangs up mid-reply must not SIGPIPE the server
+static bool sendAll(int fd, const std::string &data){
+    size_t off = 0;
+    while (off < data.size()){
+        ssize_t w = send(fd, data.data() + off, data.size() - off, MSG_NOSIGNAL);
+        if (w < 0 && errno == EINTR) continue;
+        if (w <= 0) return false;
+        off += (size_t)w;
+    }
+    return true;
+}
+
+void HeadlessController::serveSocket(const std::string &path){
+    sockaddr_un addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(addr.sun_path)) throw InputError("Socket path too long: " + path);
+    std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+
+    // Only ever replace a stale socket, never some other file at that path
+    struct stat st;
+    if (lstat(path.c_str(), &st) == 0){
+        if (!S_ISSOCK(st.st_mode)) throw InputError("Refusing to replace non-socket file: " + path);
+        unlink(path.c_str());
+    }
+
+    int srv = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (srv < 0) throw std::runtime_error("socket() failed: " + std::string(std::strerror(errno)));
+    if (bind(srv, (sockaddr*)&addr, sizeof(addr)) < 0 || listen(srv, 4) < 0){
+        std::string err = std::strerror(errno);
+        close(srv);
+        throw std::runtime_error("Cannot listen on " + path + ": " + err);
+    }
+    std::cerr << "Headless control listening on " << path << "\n";
+
+    // One client at a time; commands mutate shared simulator state
+    while (!shutdown_){
+        int fd = accept(srv, nullptr, nullptr);
+        if (fd < 0){
+            if (errno == EINTR || errno == ECONNABORTED) continue;
+            std::string err = std::strerror(errno);
+            close(srv);
+            unlink(path.c_str());
+            throw std::runtime_error("accept() failed on " + path + ": " + err);
+        }
+        std::string pending;
+        char buf[4096];
+        ssize_t n;
+        bool gone = false;  // client hung up; drop it and accept the next one
+        while (!shutdown_ && !gone && (n = read(fd, buf, sizeof(buf))) > 0){
+            pending.append(buf, (size_t)n);
+            size_t nl;
+            while ((nl = pending.find('\n')) != std::string::npos){
+                std::string line = pending.substr(0, nl);
+                pending.erase(0, nl + 1);
+                if (trim(line).empty()) continue;
+                if (!sendAll(fd, handle(line) + "\n")){ gone = true; break; }
+                if (shutdown_) break;
+            }
+        }
+        close(fd);
+    }
+    close(srv);
+    unlink(path.c_str());
+}
+
+// --- COMMANDS ---
+
+std::string HeadlessController::cmdConfigure(const JsonValue &req){
+    // Validate everything before touching the simulator
+    std::string techName = req.getString("tech", sim_.tech_->name());
+    auto tech = sim_.makeTech(techName);
+    double bw = req.getNumber("bandwidth_mhz", sim_.bandwidth_mhz_);
+    int ant = (int)req.getInt("antennas", sim_.antennas_, 1, INT_MAX);
+    std::string strategy = req.getString("strategy", sim_.allocation_strategy_);
+    int ovh = (int)req.getInt("overhead_per_100", sim_.overhead_per_100_, 0, INT_MAX);
+    int cap = (int)req.getInt("core_capacity", sim_.core_capacity_msgs_, 1, INT_MAX);
+    if (bw <= 0.0) throw InputError("bandwidth_mhz must be positive");
+    if (ant < 1 || ant > tech->max_antennas())
+        throw InputError(techName + " supports 1 to " + std::to_string(tech->max_antennas()) + " antennas");
+    if (strategy != "best_fit" && strategy != "round_robin") throw InputError("Unknown strategy: " + strategy);
+
+    sim_.tech_ = tech;           sim_.tower_.setTechnology(tech);
+    sim_.bandwidth_mhz_ = bw;    sim_.tower_.setBandwidth(bw);
+    sim_.antennas_ = ant;        sim_.tower_.setAntennas(ant);
+    sim_.allocation_strategy_ = strategy;
+    sim_.overhead_per_100_ = ovh; sim_.core_.setOverheadPer100(ovh);
+    sim_.core_capacity_msgs_ = cap; sim_.core_.setCoreCapacity(cap);
+    last_run_.valid = false;
+    return ",\"capacity\":" + std::to_string(sim_.tower_.totalCapacity());
+}
+
+void HeadlessController::applyFields(Subscriber &s, const JsonValue &set) const {
+    s.name = set.getString("name", s.name);
+    s.phone = set.getString("phone", s.phone);
+    s.type = set.getString("type", s.type);
+    s.messages = (int)set.getInt("msg", s.messages, 0, INT_MAX);
+    s.tech = set.getString("tech", s.tech);
+    if (!isValidName(s.name)) throw InputError("Invalid Name (Letters only)");
+    if (!isValidPhone(s.phone)) throw InputError("Invalid Phone (Digits only)");
+    sim_.tech_->validate_usage(s.type, s.messages);
+}
+
+std::string HeadlessController::cmdAdd(const JsonValue &req){
+    const JsonValue *users = req.get("users");
+    if (!users || users->type != JsonValue::Array) throw InputError("add needs a \"users\" array");
+
+    std::ostringstream ids, errors;
+    long added = 0, failed = 0;
+    size_t cap = (size_t)sim_.tower_.totalCapacity();
+    sim_.subs_.reserve(sim_.subs_.size() + users->items.size());
+
+    for (size_t i = 0; i < users->items.size(); ++i){
+        Subscriber s; s.id = sim_.next_id_; s.dropped = false; s.assigned_channel = -1; s.messages = 0;
+        try {
+            if (users->items[i].type != JsonValue::Object) throw InputError("User entry must be an object");
+            applyFields(s, users->items[i]);
+            if (sim_.subs_.size() >= cap) throw InputError("Capacity Reached");
+            sim_.subs_.add(s);
+            sim_.next_id_++;
+            ids << (added++ ? "," : "") << s.id;
+        } catch (const std::exception &e){
+            errors << (failed++ ? "," : "") << "{\"index\":" << i << ",\"error\":\"" << jsonEscape(e.what()) << "\"}";
+        }
+    }
+    return ",\"added\":" + std::to_string(added) + ",\"ids\":[" + ids.str() + "]"
+         + ",\"failed\":" + std::to_string(failed) + ",\"errors\":[" + errors.str() + "]";
+}
+
+std::function<bool(const Subscriber&)> HeadlessController::makeFilter(const JsonValue &where){
+    if (where.type != JsonValue::Object) throw InputError("\"where\" must be an object");
+    std::string type = where.getString("type"), tech = where.getString("tech");
+    const JsonValue *dropped = where.get("dropped");
+    bool wantDropped = where.getBool("dropped");
+    long minMsg = where.getInt("min_msg", -1, 0, INT_MAX), maxMsg = where.getInt("max_msg", -1, 0, INT_MAX);
+
+    return [=](const Subscriber &s){
+        if (!type.empty() && s.type != type) return false;
+        if (!tech.empty() && s.tech != tech) return false;
+        if (dropped && s.dropped != wantDropped) return false;
+        if (minMsg >= 0 && s.messages < minMsg) return false;
+        if (maxMsg >= 0 && s.messages > maxMsg) return false;
+        return true;
+    };
+}
+
+std::string HeadlessController::cmdEdit(const JsonValue &req){
+    const JsonValue *set = req.get("set");
+    if (!set || set->type != JsonValue::Object) throw InputError("edit needs a \"set\" object");
+
+    if (req.get("id")){
+        int id = (int)req.getInt("id", 0, 0, INT_MAX);
+        const Subscriber *cur = sim_.subs_.find(id);
+        if (!cur) throw InputError("Unknown subscriber id " + std::to_string(id));
+        Subscriber next = *cur;
+        applyFields(next, *set);
+        sim_.subs_.update(id, next);
+        return ",\"updated\":1";
+    }
+
+    const JsonValue *where = req.get("where");
+    if (!where) throw InputError("edit needs \"id\" or \"where\"");
+    if (set->get("phone")) throw InputError("Bulk edit cannot assign one phone to many users");
+
+    // Validate every match first so a bad value never leaves a half-applied edit
+    auto filter = makeFilter(*where);
+    for (const auto &s : sim_.subs_){
+        if (!filter(s)) continue;
+        Subscriber check = s;
+        applyFields(check, *set);
+    }
+
+    size_t n = sim_.subs_.updateIf(filter, [this, set](Subscriber &s){ applyFields(s, *set); });
+    return ",\"updated\":" + std::to_string(n);
+}
+
+std::string HeadlessController::cmdDelete(const JsonValue &req){
+    size_t removed = 0;
+    if (const JsonValue *ids = req.get("ids")){
+        if (ids->type != JsonValue::Array) throw InputError("\"ids\" must be an array");
+        for (const auto &v : ids->items){
+            if (sim_.deleteUser((int)v.toInt("ids", 0, INT_MAX))) removed++;
+        }
+    } else if (const JsonValue *where = req.get("where")){
+        removed = sim_.deleteUsersIf(makeFilter(*where));
+    } else {
+        throw InputError("delete needs \"ids\" or \"where\"");
+    }
+    return ",\"deleted\":" + std::to_string(removed);
+}
+
+std::string HeadlessController::cmdRun(){
+    // Allocation + core accounting without per-device threads or console output
+    sim_.tower_.allocate(sim_.subs_.all(), sim_.allocation_strategy_);
+    RunResult r;
+    uint8_t techIdx = (uint8_t)Tariff::techIndex(sim_.tech_->name());
+    uint32_t now = localSecondsOfDay();
+    sim_.rating_.reset();
+    for (const auto &s : sim_.subs_){
+        if (s.dropped) { r.dropped++; continue; }
+        r.admitted++;
+        r.messages += s.messages;
+        // Each subscriber's whole quota in as few records as fit uint16 units
+        sim_.rating_.submitUsage((uint32_t)s.id, now, techIdx, (uint8_t)Tariff::serviceIndex(s.type), s.messages);
+    }
+    RatingSummary billing;
+    sim_.rating_.finalize(billing);
+    r.revenue = billing.revenue;
+    r.overhead = sim_.core_.overheadFor(r.messages);
+    r.cores = sim_.core_.coresNeeded(r.messages);
+    r.valid = true;
+    last_run_ = r;
+
+    std::ostringstream o;
+    o << ",\"admitted\":" << r.admitted << ",\"dropped\":" << r.dropped
+      << ",\"messages\":" << r.messages << ",\"overhead\":" << r.overhead
+      << ",\"cores\":" << r.cores
+      << std::fixed << std::setprecision(2) << ",\"revenue\":" << r.revenue;
+    return o.str();
+}
+
+std::string HeadlessController::cmdStats() const {
+    const RosterStats &st = sim_.subs_.stats();
+    long users = (long)sim_.subs_.size();
+    int cap = sim_.tower_.totalCapacity();
+
+    std::ostringstream o;
+    o << std::fixed << std::setprecision(2);
+    o << ",\"tech\":\"" << sim_.tech_->name() << "\""
+      << ",\"bandwidth_mhz\":" << sim_.bandwidth_mhz_
+      << ",\"antennas\":" << sim_.antennas_
+      << ",\"capacity\":" << cap
+      << ",\"users\":" << users
+      << ",\"data_users\":" << st.data_users
+      << ",\"voice_users\":" << st.voice_users
+      << ",\"offered_messages\":" << st.total_messages
+      << ",\"load_pct\":" << (cap > 0 ? 100.0 * users / cap : 0.0)
+      << ",\"latency_ms\":" << (cap > 0 ? sim_.calculateCurrentLatency() : 0.0);
+    if (last_run_.valid){
+        o << ",\"last_run\":{\"admitted\":" << last_run_.admitted
+          << ",\"dropped\":" << last_run_.dropped
+          << ",\"messages\":" << last_run_.messages
+          << ",\"overhead\":" << last_run_.overhead
+          << ",\"cores\":" << last_run_.cores
+          << ",\"revenue\":" << last_run_.revenue << "}";
+    }
+    return o.str();
+}
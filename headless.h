@@ -0,0 +1,46 @@
+#pragma once
+#include <string>
+#include <istream>
+#include <ostream>
+#include <functional>
+#include "json.h"
+#include "subscriber.h"
+
+class Simulator;
+
+// JSON-lines control protocol: one command object per line in, one response
+// object per line out. Commands: configure, add, edit, delete, run, stats,
+// shutdown. An optional "seq" field is echoed back in the response.
+class HeadlessController {
+public:
+    explicit HeadlessController(Simulator &sim);
+
+    std::string handle(const std::string &line);
+    void serve(std::istream &in, std::ostream &out);
+    void serveSocket(const std::string &path);
+
+private:
+    std::string cmdConfigure(const JsonValue &req);
+    std::string cmdAdd(const JsonValue &req);
+    std::string cmdEdit(const JsonValue &req);
+    std::string cmdDelete(const JsonValue &req);
+    std::string cmdRun();
+    std::string cmdStats() const;
+
+    static std::function<bool(const Subscriber&)> makeFilter(const JsonValue &where);
+    void applyFields(Subscriber &s, const JsonValue &set) const;
+
+    struct RunResult {
+        bool valid = false;
+        long admitted = 0;
+        long dropped = 0;
+        long messages = 0;
+        long overhead = 0;
+        int cores = 0;
+        double revenue = 0.0;
+    };
+
+    Simulator &sim_;
+    RunResult last_run_;
+    bool shutdown_;
+};
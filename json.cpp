@@ -0,0 +1,232 @@
+#include "json.h"
+#include "utils.h"
+
+#include <cctype>
+#include <cstdlib>
+#include <cstdio>
+#include <cmath>
+
+namespace {
+
+class JsonParser {
+public:
+    explicit JsonParser(const std::string &t) : t_(t), i_(0), depth_(0) {}
+
+    JsonValue parseDocument(){
+        JsonValue v = parseValue();
+        skipWs();
+        if (i_ != t_.size()) fail("trailing characters");
+        return v;
+    }
+
+private:
+    [[noreturn]] void fail(const std::string &what) const {
+        throw InputError("JSON error at offset " + std::to_string(i_) + ": " + what);
+    }
+
+    void skipWs(){ while (i_ < t_.size() && std::isspace((unsigned char)t_[i_])) i_++; }
+
+    void expect(char c){
+        skipWs();
+        if (i_ >= t_.size() || t_[i_] != c) fail(std::string("expected '") + c + "'");
+        i_++;
+    }
+
+    bool consumeWord(const char *w){
+        size_t n = std::char_traits<char>::length(w);
+        if (t_.compare(i_, n, w) != 0) return false;
+        i_ += n;
+        return true;
+    }
+
+    JsonValue parseValue(){
+        skipWs();
+        if (i_ >= t_.size()) fail("unexpected end of input");
+        JsonValue v;
+        char c = t_[i_];
+        if (c == '{') return parseObject();
+        if (c == '[') return parseArray();
+        if (c == '"'){ v.type = JsonValue::String; v.str = parseString(); return v; }
+        if (consumeWord("true")){ v.type = JsonValue::Bool; v.boolean = true; return v; }
+        if (consumeWord("false")){ v.type = JsonValue::Bool; v.boolean = false; return v; }
+        if (consumeWord("null")) return v;
+        if (c == '-' || std::isdigit((unsigned char)c)){
+            const char *start = t_.c_str() + i_;
+            char *end = nullptr;
+            v.type = JsonValue::Number;
+            v.number = std::strtod(start, &end);
+            if (end == start) fail("invalid number");
+            if (!std::isfinite(v.number)) fail("number out of range");
+            i_ += (size_t)(end - start);
+            return v;
+        }
+        fail(std::string("unexpected character '") + c + "'");
+    }
+
+    // Containers recurse; cap the depth so hostile input cannot blow the stack
+    void enter(){ if (++depth_ > JSON_MAX_DEPTH) fail("nesting deeper than " + std::to_string(JSON_MAX_DEPTH)); }
+
+    JsonValue parseObject(){
+        JsonValue v; v.type = JsonValue::Object;
+        expect('{');
+        enter();
+        skipWs();
+        if (i_ < t_.size() && t_[i_] == '}'){ i_++; depth_--; return v; }
+        while (true){
+            skipWs();
+            if (i_ >= t_.size() || t_[i_] != '"') fail("expected object key");
+            std::string key = parseString();
+            expect(':');
+            v.fields.emplace_back(key, parseValue());
+            skipWs();
+            if (i_ < t_.size() && t_[i_] == ','){ i_++; continue; }
+            expect('}');
+            depth_--;
+            return v;
+        }
+    }
+
+    JsonValue parseArray(){
+        JsonValue v; v.type = JsonValue::Array;
+        expect('[');
+        enter();
+        skipWs();
+        if (i_ < t_.size() && t_[i_] == ']'){ i_++; depth_--; return v; }
+        while (true){
+            v.items.push_back(parseValue());
+            skipWs();
+            if (i_ < t_.size() && t_[i_] == ','){ i_++; continue; }
+            expect(']');
+            depth_--;
+            return v;
+        }
+    }
+
+    // Exactly four hex digits of a \u escape
+    unsigned hex4(){
+        if (i_ + 4 > t_.size()) fail("invalid \\u escape");
+        unsigned v = 0;
+        for (int k = 0; k < 4; ++k){
+            char c = t_[i_ + k];
+            if (!std::isxdigit((unsigned char)c)) fail("invalid \\u escape");
+            v = v * 16 + (unsigned)(std::isdigit((unsigned char)c) ? c - '0' : std::tolower((unsigned char)c) - 'a' + 10);
+        }
+        i_ += 4;
+        return v;
+    }
+
+    std::string parseString(){
+        std::string out;
+        i_++; // opening quote
+        while (i_ < t_.size()){
+            char c = t_[i_++];
+            if (c == '"') return out;
+            if (c != '\\'){ out += c; continue; }
+            if (i_ >= t_.size()) break;
+            char e = t_[i_++];
+            switch (e){
+                case '"': out += '"'; break;
+                case '\\': out += '\\'; break;
+                case '/': out += '/'; break;
+                case 'b': out += '\b'; break;
+                case 'f': out += '\f'; break;
+                case 'n': out += '\n'; break;
+                case 'r': out += '\r'; break;
+                case 't': out += '\t'; break;
+                case 'u': {
+                    unsigned cp = hex4();
+                    if (cp >= 0xDC00 && cp <= 0xDFFF) fail("invalid \\u escape (lone low surrogate)");
+                    if (cp >= 0xD800 && cp <= 0xDBFF){
+                        // High surrogate: must be followed by \uDC00-\uDFFF
+                        if (t_.compare(i_, 2, "\\u") != 0) fail("invalid \\u escape (lone high surrogate)");
+                        i_ += 2;
+                        unsigned lo = hex4();
+                        if (lo < 0xDC00 || lo > 0xDFFF) fail("invalid \\u escape (lone high surrogate)");
+                        cp = 0x10000 + ((cp - 0xD800) << 10) + (lo - 0xDC00);
+                    }
+                    if (cp < 0x80) out += (char)cp;
+                    else if (cp < 0x800){ out += (char)(0xC0 | (cp >> 6)); out += (char)(0x80 | (cp & 0x3F)); }
+                    else if (cp < 0x10000){ out += (char)(0xE0 | (cp >> 12)); out += (char)(0x80 | ((cp >> 6) & 0x3F)); out += (char)(0x80 | (cp & 0x3F)); }
+                    else {
+                        out += (char)(0xF0 | (cp >> 18)); out += (char)(0x80 | ((cp >> 12) & 0x3F));
+                        out += (char)(0x80 | ((cp >> 6) & 0x3F)); out += (char)(0x80 | (cp & 0x3F));
+                    }
+                    break;
+                }
+                default: fail("invalid escape");
+            }
+        }
+        fail("unterminated string");
+    }
+
+    const std::string &t_;
+    size_t i_;
+    int depth_;
+};
+
+} // namespace
+
+const JsonValue *JsonValue::get(const std::string &key) const {
+    for (const auto &f : fields) if (f.first == key) return &f.second;
+    return nullptr;
+}
+
+std::string JsonValue::getString(const std::string &key, const std::string &def) const {
+    const JsonValue *v = get(key);
+    if (!v || v->type == Null) return def;
+    if (v->type != String) throw InputError("Field '" + key + "' must be a string");
+    return v->str;
+}
+
+double JsonValue::getNumber(const std::string &key, double def) const {
+    const JsonValue *v = get(key);
+    if (!v || v->type == Null) return def;
+    if (v->type != Number) throw InputError("Field '" + key + "' must be a number");
+    return v->number;
+}
+
+bool JsonValue::getBool(const std::string &key, bool def) const {
+    const JsonValue *v = get(key);
+    if (!v || v->type == Null) return def;
+    if (v->type != Bool) throw InputError("Field '" + key + "' must be true or false");
+    return v->boolean;
+}
+
+long JsonValue::toInt(const std::string &what, long lo, long hi) const {
+    if (type != Number) throw InputError("Field '" + what + "' must be a number");
+    if (number != std::floor(number)) throw InputError("Field '" + what + "' must be a whole number");
+    if (number < (double)lo || number > (double)hi)
+        throw InputError("Field '" + what + "' must be between " + std::to_string(lo) + " and " + std::to_string(hi));
+    return (long)number;
+}
+
+long JsonValue::getInt(const std::string &key, long def, long lo, long hi) const {
+    const JsonValue *v = get(key);
+    if (!v || v->type == Null) return def;
+    return v->toInt(key, lo, hi);
+}
+
+JsonValue parseJson(const std::string &text){
+    return JsonParser(text).parseDocument();
+}
+
+std::string jsonEscape(const std::string &s){
+    std::string out;
+    out.reserve(s.size() + 2);
+    for (unsigned char c : s){
+        switch (c){
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (c < 0x20){
+                    char buf[8];
+                    std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+                    out += buf;
+                } else out += (char)c;
+        }
+    }
+    return out;
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <utility>
+
+// Minimal JSON value for the headless command protocol (one object per line).
+struct JsonValue {
+    enum Type { Null, Bool, Number, String, Array, Object };
+
+    Type type = Null;
+    bool boolean = false;
+    double number = 0.0;
+    std::string str;
+    std::vector<JsonValue> items;
+    std::vector<std::pair<std::string, JsonValue>> fields;
+
+    const JsonValue *get(const std::string &key) const;
+
+    // Typed field access; throw InputError when present with the wrong type
+    std::string getString(const std::string &key, const std::string &def = "") const;
+    double getNumber(const std::string &key, double def = 0.0) const;
+    bool getBool(const std::string &key, bool def = false) const;
+    // Whole number in [lo, hi]; `def` is returned as-is when the field is absent
+    long getInt(const std::string &key, long def, long lo, long hi) const;
+
+    // This value as a whole number in [lo, hi]; `what` names it in errors
+    long toInt(const std::string &what, long lo, long hi) const;
+};
+
+// Throws InputError on malformed input, non-finite numbers or nesting deeper
+// than JSON_MAX_DEPTH.
+const int JSON_MAX_DEPTH = 64;
+JsonValue parseJson(const std::string &text);
+
+std::string jsonEscape(const std::string &s);
@@ -1,8 +1,33 @@
 #include "simulator.h"
+#include "tracereader.h"
+#include "headless.h"
+#include "timeline.h"
+#include "utils.h"
 #include <iostream>
 
+// Writes the timeline when main returns, whichever mode ran
+struct TimelineDump {
+    std::string path;
+    ~TimelineDump(){
+        if (path.empty()) return;
+        try {
+            Timeline::writeJson(path);
+            std::cerr << "Timeline written to " << path << std::endl;
+        } catch (const std::exception &e){
+            std::cerr << "Error: " << e.what() << std::endl;
+        }
+    }
+};
+
 int main(int argc, char **argv){
     Simulator sim;
+    TimelineDump timeline;
+    // Timeline tracing: --timeline <out.json> may precede any other mode
+    if (argc >= 3 && std::string(argv[1]) == "--timeline"){
+        timeline.path = argv[2];
+        Timeline::enable();
+        argc -= 2; argv += 2;
+    }
     if (argc == 3 && std::string(argv[1]) == "--file"){
         try {
             sim.runFromFile(argv[2]);
@@ -12,6 +37,79 @@ int main(int argc, char **argv){
         }
         return 0;
     }
+    // Multi-carrier site: --site <config>
+    if (argc == 3 && std::string(argv[1]) == "--site"){
+        try {
+            sim.runSite(argv[2]);
+        } catch (const std::exception &e){
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+    // Capacity planner: --plan <config> <drop_rate>
+    //                   --plan-projection <subscribers> <type> <messages> <drop_rate>
+    if ((argc == 4 && std::string(argv[1]) == "--plan") ||
+        (argc == 6 && std::string(argv[1]) == "--plan-projection")){
+        try {
+            if (argc == 4) sim.planFromFile(argv[2], to_double(argv[3]));
+            else sim.planProjection(to_long(argv[2]), argv[3], to_int(argv[4]), to_double(argv[5]));
+        } catch (const std::exception &e){
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+    // Synthetic workload: --generate <spec> [out.cfg]
+    if ((argc == 3 || argc == 4) && std::string(argv[1]) == "--generate"){
+        try {
+            sim.generateWorkload(argv[2], argc == 4 ? argv[3] : "");
+        } catch (const std::exception &e){
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+    // Headless control: --headless (JSON lines on stdin/stdout) | --headless-socket <path>
+    if ((argc == 2 && std::string(argv[1]) == "--headless") ||
+        (argc == 3 && std::string(argv[1]) == "--headless-socket")){
+        try {
+            HeadlessController ctl(sim);
+            if (argc == 2) ctl.serve(std::cin, std::cout);
+            else ctl.serveSocket(argv[2]);
+        } catch (const std::exception &e){
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+    // Trace replay: --replay <config> <trace> [speed|max]
+    if ((argc == 4 || argc == 5) && std::string(argv[1]) == "--replay"){
+        try {
+            double speed = 1.0;
+            if (argc == 5) speed = (std::string(argv[4]) == "max") ? 0.0 : to_double(argv[4]);
+            sim.replayTrace(argv[2], argv[3], speed);
+        } catch (const std::exception &e){
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+    // CSV -> compact binary trace: --trace-convert <in.csv> <out.bin>
+    if (argc == 4 && std::string(argv[1]) == "--trace-convert"){
+        try {
+            TraceReader in(argv[2]);
+            TraceWriter out(argv[3]);
+            TraceEvent ev;
+            while (in.next(ev)) out.write(ev);
+            out.close();
+            std::cout << "Converted " << in.eventsRead() << " events to " << argv[3] << std::endl;
+        } catch (const std::exception &e){
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 1;
+        }
+        return 0;
+    }
     // Interactive menu mode
     sim.menuLoop();
     return 0;
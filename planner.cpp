@@ -0,0 +1,162 @@
+#include "planner.h"
+#include "celltower.h"
+#include "utils.h"
+
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <algorithm>
+#include <climits>
+#include <map>
+
+CapacityPlanner::CapacityPlanner(const CellularCore &core, PlannerCosts costs)
+: core_(core), costs_(costs), demand_() {}
+
+void CapacityPlanner::setDemand(const std::vector<Subscriber> &roster){
+    // Collapse the roster into (type, messages) buckets so planning cost
+    // does not depend on the number of subscribers.
+    std::map<std::pair<std::string,int>, long> buckets;
+    for (const auto &s : roster) buckets[{s.type, s.messages}]++;
+
+    demand_.clear();
+    for (const auto &b : buckets) demand_.push_back({b.first.first, b.first.second, b.second});
+}
+
+void CapacityPlanner::setProjection(long subscribers, const std::string &type, int messages){
+    if (subscribers <= 0) throw InputError("Projection needs at least one subscriber");
+    if (messages < 0) throw InputError("Projection message count cannot be negative");
+    demand_.clear();
+    demand_.push_back({type, messages, subscribers});
+}
+
+long CapacityPlanner::totalSubscribers() const {
+    long n = 0;
+    for (const auto &b : demand_) n += b.count;
+    return n;
+}
+
+std::vector<std::shared_ptr<Technology>> CapacityPlanner::allTechnologies(){
+    return { std::make_shared<TwoG>(), std::make_shared<ThreeG>(),
+             std::make_shared<FourG>(), std::make_shared<FiveG>() };
+}
+
+long CapacityPlanner::capacityFor(const Technology &t, int channels, int antennas){
+    return (long)channels * t.users_per_channel() * antennas;
+}
+
+// Smallest channel count whose capacity covers `needed`. Capacity is monotonic in
+// the channel count, so grow an upper bound by doubling and binary search below it.
+int CapacityPlanner::minChannelsFor(const Technology &t, int antennas, long needed){
+    if (needed <= 0) return 1;
+    long hi = 1;
+    while (capacityFor(t, (int)hi, antennas) < needed){
+        hi *= 2;
+        if (hi > INT_MAX) throw InputError("Demand exceeds plannable spectrum");
+    }
+    long lo = hi / 2 + 1;
+    while (lo < hi){
+        long mid = lo + (hi - lo) / 2;
+        if (capacityFor(t, (int)mid, antennas) >= needed) hi = mid; else lo = mid + 1;
+    }
+    return (int)hi;
+}
+
+std::vector<PlanCandidate> CapacityPlanner::plan(double target_drop_rate, size_t limit) const {
+    if (target_drop_rate < 0.0 || target_drop_rate >= 1.0)
+        throw InputError("Target drop rate must be in [0, 1)");
+    long total = totalSubscribers();
+    if (total == 0) throw InputError("No subscribers to plan for");
+    if (total > INT_MAX / 2) throw InputError("Demand exceeds plannable tower capacity");
+
+    long allowed_drops = (long)(total * target_drop_rate);
+    std::vector<PlanCandidate> out;
+
+    for (const auto &t : allTechnologies()){
+        // Usage limits are per technology: count what it would refuse and
+        // the traffic of everyone it would accept.
+        long rejected = 0, admissible = 0, admissible_msgs = 0;
+        for (const auto &b : demand_){
+            try {
+                t->validate_usage(b.type, b.messages);
+                admissible += b.count;
+                admissible_msgs += b.count * b.messages;
+            } catch (const std::exception &) {
+                rejected += b.count;
+            }
+        }
+        if (rejected > allowed_drops) continue; // no amount of spectrum helps
+
+        long needed = std::max(0L, admissible - (allowed_drops - rejected));
+        // Worst case every admitted subscriber sends its full quota.
+        int cores = core_.coresNeeded(admissible_msgs);
+
+        // Each extra antenna can only lower the channel count needed, so stop
+        // adding antennas once a single channel is enough.
+        for (int a = 1; a <= t->max_antennas(); ++a){
+            int ch = minChannelsFor(*t, a, needed);
+
+            // Small margin keeps channels_for_bandwidth() from truncating a channel away.
+            double bw = (ch * (double)t->channel_bandwidth_khz() + 0.01) / 1000.0;
+
+            CellTower tower;
+            tower.setTechnology(t);
+            tower.setBandwidth(bw);
+            tower.setAntennas(a);
+
+            PlanCandidate c;
+            c.tech = t->name();
+            c.bandwidth_mhz = bw;
+            c.antennas = a;
+            c.channels = tower.channels();
+            c.capacity = tower.totalCapacity();
+            c.carried = std::min(admissible, c.capacity);
+            c.rejected = rejected;
+            c.drop_rate = (double)(total - c.carried) / total;
+            c.headroom_pct = (c.capacity > 0) ? 100.0 * (c.capacity - c.carried) / c.capacity : 0.0;
+            c.cores = cores;
+            c.cost = ch * t->channel_bandwidth_khz() / 1000.0 * costs_.per_mhz
+                   + a * costs_.per_antenna + cores * costs_.per_core;
+            out.push_back(c);
+            if (ch == 1) break;
+        }
+    }
+
+    std::sort(out.begin(), out.end(), [](const PlanCandidate &x, const PlanCandidate &y){
+        if (x.cost != y.cost) return x.cost < y.cost;
+        return x.headroom_pct > y.headroom_pct;
+    });
+    if (out.size() > limit) out.resize(limit);
+    return out;
+}
+
+void CapacityPlanner::printPlan(const std::vector<PlanCandidate> &plan, double target_drop_rate){
+    std::cout << "\n" << CYAN << "--- CAPACITY PLAN (target drop <= "
+              << std::fixed << std::setprecision(2) << target_drop_rate * 100.0 << "%) ---" << RESET << "\n";
+    if (plan.empty()){
+        std::cout << RED << "No feasible configuration: every technology rejects too much of the roster." << RESET << "\n";
+        return;
+    }
+    std::cout << std::left << std::setw(6) << "Tech"
+              << std::setw(14) << "Bandwidth"
+              << std::setw(8) << "MIMO"
+              << std::setw(8) << "Cores"
+              << std::setw(12) << "Capacity"
+              << std::setw(10) << "Drop%"
+              << std::setw(11) << "Headroom"
+              << "Cost" << "\n";
+    std::cout << "------------------------------------------------------------------------\n";
+    for (const auto &c : plan){
+        std::ostringstream bw, ant;
+        bw << std::fixed << std::setprecision(3) << c.bandwidth_mhz << " MHz";
+        ant << c.antennas << "x";
+        std::cout << std::left << std::setw(6) << c.tech
+                  << std::setw(14) << bw.str()
+                  << std::setw(8) << ant.str()
+                  << std::setw(8) << c.cores
+                  << std::setw(12) << c.capacity
+                  << std::setw(10) << std::setprecision(2) << c.drop_rate * 100.0
+                  << std::setw(11) << std::setprecision(1) << c.headroom_pct
+                  << GREEN << "$" << std::setprecision(2) << c.cost << RESET << "\n";
+    }
+    std::cout << "------------------------------------------------------------------------\n";
+}
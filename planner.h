@@ -0,0 +1,60 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <memory>
+#include "technology.h"
+#include "core.h"
+#include "subscriber.h"
+
+// One bucket of demand: `count` subscribers of the same type sending `messages` each.
+// A roster collapses into a handful of buckets, a growth projection is a single one.
+struct DemandBucket {
+    std::string type;
+    int messages;
+    long count;
+};
+
+// Relative prices used to rank feasible configurations.
+struct PlannerCosts {
+    double per_mhz = 10.0;
+    double per_antenna = 25.0;
+    double per_core = 40.0;
+};
+
+struct PlanCandidate {
+    std::string tech;
+    double bandwidth_mhz;
+    int antennas;
+    int channels;
+    long capacity;
+    long carried;       // subscribers admitted by this config
+    long rejected;      // subscribers the technology refuses (usage limits)
+    double drop_rate;   // (overflow + rejected) / total
+    double headroom_pct;
+    int cores;
+    double cost;
+};
+
+class CapacityPlanner {
+public:
+    CapacityPlanner(const CellularCore &core, PlannerCosts costs = PlannerCosts());
+
+    void setDemand(const std::vector<Subscriber> &roster);
+    void setProjection(long subscribers, const std::string &type, int messages);
+
+    long totalSubscribers() const;
+
+    // Cheapest configs meeting `target_drop_rate`, sorted by cost (at most `limit`).
+    std::vector<PlanCandidate> plan(double target_drop_rate, size_t limit = 10) const;
+
+    static void printPlan(const std::vector<PlanCandidate> &plan, double target_drop_rate);
+
+private:
+    static std::vector<std::shared_ptr<Technology>> allTechnologies();
+    static long capacityFor(const Technology &t, int channels, int antennas);
+    static int minChannelsFor(const Technology &t, int antennas, long needed);
+
+    CellularCore core_;
+    PlannerCosts costs_;
+    std::vector<DemandBucket> demand_;
+};
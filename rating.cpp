@@ -0,0 +1,266 @@
+#include "rating.h"
+#include "utils.h"
+
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <map>
+#include <ctime>
+
+uint32_t localSecondsOfDay(){
+    std::time_t now = std::time(nullptr);
+    std::tm lt = *std::localtime(&now);
+    return (uint32_t)(lt.tm_hour * 3600 + lt.tm_min * 60 + lt.tm_sec);
+}
+
+// --- TARIFF ---
+
+Tariff::Tariff() : peak_start_s_(8 * 3600), peak_end_s_(20 * 3600), tiers_() {
+    const double flat[4] = {0.01, 0.01, 0.03, 0.05};
+    for (int t = 0; t < 4; ++t)
+        for (int s = 0; s < 3; ++s)
+            for (int p = 0; p < 2; ++p)
+                rates_[(t * 3 + s) * 2 + p] = flat[t];
+}
+
+int Tariff::techIndex(const std::string &name){
+    if (name == "2G") return 0;
+    if (name == "3G") return 1;
+    if (name == "4G") return 2;
+    if (name == "5G") return 3;
+    throw InputError("Unknown technology in tariff: " + name);
+}
+
+int Tariff::serviceIndex(const std::string &type){
+    if (type == "data" || type == "Data" || type == "DATA") return 0;
+    if (type == "voice" || type == "Voice" || type == "VOICE") return 1;
+    return 2;
+}
+
+int Tariff::parseService(const std::string &name){
+    if (name == "data" || name == "Data" || name == "DATA") return 0;
+    if (name == "voice" || name == "Voice" || name == "VOICE") return 1;
+    if (name == "both" || name == "Both" || name == "BOTH") return 2;
+    throw InputError("Unknown service in tariff: " + name);
+}
+
+double Tariff::rate(int tech, int service, bool peak) const {
+    return rates_[(tech * 3 + service) * 2 + (peak ? 1 : 0)];
+}
+
+bool Tariff::isPeak(uint32_t t) const {
+    if (peak_start_s_ <= peak_end_s_) return t >= peak_start_s_ && t < peak_end_s_;
+    return t >= peak_start_s_ || t < peak_end_s_; // window wraps midnight
+}
+
+// Format (same key=value / k:v style as the simulator config):
+//   peak_hours=8-20
+//   rate=tech:5G,service:data,peak:0.06,offpeak:0.04   (service may be "all")
+//   tier=above:100,multiplier:0.8
+void Tariff::load(const std::string &path){
+    std::ifstream f(path);
+    if (!f) throw InputError("Cannot open tariff file: " + path);
+    std::string line;
+    while (std::getline(f, line)){
+        line = trim(line);
+        if (line.empty() || line[0] == '#') continue;
+        auto eq = line.find('=');
+        if (eq == std::string::npos) continue;
+        std::string key = trim(line.substr(0, eq));
+        std::string val = trim(line.substr(eq + 1));
+
+        if (key == "peak_hours"){
+            auto dash = val.find('-');
+            if (dash == std::string::npos) throw InputError("peak_hours must look like 8-20");
+            int a = to_int(trim(val.substr(0, dash))), b = to_int(trim(val.substr(dash + 1)));
+            if (a < 0 || a > 24 || b < 0 || b > 24) throw InputError("peak_hours out of range: " + val);
+            peak_start_s_ = (uint32_t)a * 3600;
+            peak_end_s_ = (uint32_t)b * 3600;
+            continue;
+        }
+
+        std::map<std::string, std::string> kv;
+        std::stringstream ss(val);
+        std::string segment;
+        while (std::getline(ss, segment, ',')){
+            auto c = segment.find(':');
+            if (c == std::string::npos) continue;
+            kv[trim(segment.substr(0, c))] = trim(segment.substr(c + 1));
+        }
+        auto need = [&kv, &line](const std::string &k) -> const std::string & {
+            auto it = kv.find(k);
+            if (it == kv.end()) throw InputError("Tariff line is missing '" + k + "': " + line);
+            return it->second;
+        };
+
+        if (key == "rate"){
+            int t = techIndex(need("tech"));
+            std::string svc = kv.count("service") ? kv["service"] : "all";
+            int only = svc == "all" ? -1 : parseService(svc);
+            double peak = to_double(need("peak"));
+            double off = kv.count("offpeak") ? to_double(kv["offpeak"]) : peak;
+            if (peak < 0.0 || off < 0.0) throw InputError("Negative rate in tariff: " + line);
+            for (int s = 0; s < 3; ++s){
+                if (only >= 0 && only != s) continue;
+                rates_[(t * 3 + s) * 2 + 1] = peak;
+                rates_[(t * 3 + s) * 2 + 0] = off;
+            }
+        } else if (key == "tier"){
+            Tier tier{ to_int(need("above")), to_double(need("multiplier")) };
+            if (tier.above_units < 0 || tier.multiplier < 0.0 || tier.multiplier > 1.0)
+                throw InputError("Invalid tier: " + line);
+            tiers_.push_back(tier);
+        }
+    }
+    std::sort(tiers_.begin(), tiers_.end(), [](const Tier &a, const Tier &b){ return a.above_units < b.above_units; });
+}
+
+// --- RATING ENGINE ---
+
+RatingEngine::RatingEngine(size_t batch_size)
+: tariff_(), batch_size_(std::max<size_t>(1, batch_size)), records_(0) {
+    ids_.reserve(batch_size_);
+    times_.reserve(batch_size_);
+    classes_.reserve(batch_size_);
+    units_.reserve(batch_size_);
+}
+
+void RatingEngine::setTariff(const Tariff &t){ tariff_ = t; }
+
+void RatingEngine::reset(){
+    ids_.clear(); times_.clear(); classes_.clear(); units_.clear();
+    invoices_.clear();
+    records_ = 0;
+}
+
+void RatingEngine::submit(const UsageRecord &r){
+    ids_.push_back(r.subscriber_id);
+    times_.push_back(r.time_of_day_s);
+    classes_.push_back((uint8_t)(r.tech * 3 + r.service));
+    units_.push_back(r.units);
+    if (ids_.size() >= batch_size_) rateBatch();
+}
+
+void RatingEngine::submitUsage(uint32_t id, uint32_t tod, uint8_t tech, uint8_t service, long units){
+    if (units < 0) throw InputError("Negative usage for subscriber " + std::to_string(id));
+    while (units > 0){
+        uint16_t chunk = (uint16_t)std::min<long>(units, UINT16_MAX);
+        submit({id, tod, tech, service, chunk});
+        units -= chunk;
+    }
+}
+
+void RatingEngine::rateBatch(){
+    const size_t n = ids_.size();
+    if (n == 0) return;
+    slot_.resize(n);
+    price_.resize(n);
+
+    const uint32_t ps = tariff_.peakStart(), pe = tariff_.peakEnd();
+    const bool wraps = ps > pe;
+    const double *table = tariff_.table();
+    const uint32_t *times = times_.data();
+    const uint8_t *classes = classes_.data();
+    const uint16_t *units = units_.data();
+    uint32_t *slot = slot_.data();
+    double *price = price_.data();
+
+    // Pass 1: rate-table slot per record (branch-free, vectorisable)
+    for (size_t i = 0; i < n; ++i){
+        uint32_t inWindow = (uint32_t)(times[i] >= ps) & (uint32_t)(times[i] < pe);
+        uint32_t outWindow = (uint32_t)(times[i] >= ps) | (uint32_t)(times[i] < pe);
+        uint32_t peak = wraps ? outWindow : inWindow;
+        slot[i] = (uint32_t)classes[i] * 2 + peak;
+    }
+    // Pass 2: price = rate x units
+    for (size_t i = 0; i < n; ++i) price[i] = table[slot[i]] * units[i];
+
+    // Pass 3: scatter into dense per-subscriber invoices
+    uint32_t maxId = *std::max_element(ids_.begin(), ids_.end());
+    if (maxId >= invoices_.size()) invoices_.resize((size_t)maxId + 1);
+    for (size_t i = 0; i < n; ++i){
+        Invoice &inv = invoices_[ids_[i]];
+        inv.subscriber_id = ids_[i];
+        inv.records++;
+        inv.units[classes[i] % 3] += units[i];
+        if (slot[i] & 1) inv.peak_amount += price[i]; else inv.offpeak_amount += price[i];
+    }
+
+    records_ += (long)n;
+    ids_.clear(); times_.clear(); classes_.clear(); units_.clear();
+}
+
+std::vector<Invoice> RatingEngine::finalize(RatingSummary &s){
+    rateBatch();
+    s = RatingSummary();
+    s.records = records_;
+
+    std::vector<Invoice> out;
+    const auto &tiers = tariff_.tiers();
+    for (auto &inv : invoices_){
+        if (inv.records == 0) continue;
+        long units = inv.units[0] + inv.units[1] + inv.units[2];
+        double gross = inv.peak_amount + inv.offpeak_amount;
+
+        // Volume tiers are marginal: units between consecutive thresholds get
+        // that tier's multiplier, priced at the subscriber's average rate
+        inv.discount = 0.0;
+        if (!tiers.empty() && units > 0){
+            double avg = gross / units;
+            for (size_t k = 0; k < tiers.size(); ++k){
+                long lo = tiers[k].above_units;
+                long hi = (k + 1 < tiers.size()) ? tiers[k + 1].above_units : units;
+                long band = std::max(0L, std::min(units, hi) - lo);
+                inv.discount += band * avg * (1.0 - tiers[k].multiplier);
+            }
+        }
+
+        s.units += units;
+        s.peak_revenue += inv.peak_amount;
+        s.offpeak_revenue += inv.offpeak_amount;
+        s.discounts += inv.discount;
+        for (int k = 0; k < 3; ++k)
+            if (units > 0) s.service_revenue[k] += inv.total() * inv.units[k] / units;
+        out.push_back(inv);
+    }
+    s.revenue = s.peak_revenue + s.offpeak_revenue - s.discounts;
+    return out;
+}
+
+void RatingEngine::printReport(const std::vector<Invoice> &invoices, const RatingSummary &s, size_t maxRows){
+    std::cout << " Usage Records Rated      : " << s.records << "\n";
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << " Revenue Generated        : " << GREEN << "$" << s.revenue << RESET
+              << " (peak $" << s.peak_revenue << " | off-peak $" << s.offpeak_revenue
+              << " | discounts -$" << s.discounts << ")\n";
+    std::cout << " Revenue by Service       : data $" << s.service_revenue[0]
+              << " | voice $" << s.service_revenue[1] << " | both $" << s.service_revenue[2] << "\n";
+
+    if (invoices.empty()) return;
+    std::cout << CYAN << "------------------------------------------" << RESET << "\n";
+    std::cout << " " << std::left << std::setw(6) << "User" << std::setw(8) << "Units"
+              << std::setw(12) << "Peak" << std::setw(12) << "Off-peak" << "Total\n";
+    for (size_t i = 0; i < invoices.size() && i < maxRows; ++i){
+        const Invoice &inv = invoices[i];
+        std::cout << " " << std::left << std::setw(6) << inv.subscriber_id
+                  << std::setw(8) << (inv.units[0] + inv.units[1] + inv.units[2])
+                  << std::setw(12) << inv.peak_amount
+                  << std::setw(12) << inv.offpeak_amount
+                  << "$" << inv.total() << "\n";
+    }
+    if (invoices.size() > maxRows)
+        std::cout << " ... " << (invoices.size() - maxRows) << " more invoice(s)\n";
+}
+
+void RatingEngine::writeCsv(const std::string &path, const std::vector<Invoice> &invoices){
+    std::ofstream f(path);
+    if (!f) throw InputError("Cannot write invoices: " + path);
+    f << "subscriber_id,data_units,voice_units,both_units,peak_amount,offpeak_amount,discount,total\n";
+    f << std::fixed << std::setprecision(4);
+    for (const auto &inv : invoices){
+        f << inv.subscriber_id << "," << inv.units[0] << "," << inv.units[1] << "," << inv.units[2] << ","
+          << inv.peak_amount << "," << inv.offpeak_amount << "," << inv.discount << "," << inv.total() << "\n";
+    }
+}
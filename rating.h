@@ -0,0 +1,109 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <cstdint>
+
+// Wall-clock seconds since local midnight, for rating live simulations
+uint32_t localSecondsOfDay();
+
+// Compact usage record: one per simulated message (or per aggregated burst).
+struct UsageRecord {
+    uint32_t subscriber_id;
+    uint32_t time_of_day_s;  // seconds since midnight, picks peak/off-peak
+    uint8_t tech;            // 0..3 = 2G..5G
+    uint8_t service;         // 0 = data, 1 = voice, 2 = both
+    uint16_t units;          // messages
+};
+
+struct Invoice {
+    uint32_t subscriber_id = 0;
+    long units[3] = {0, 0, 0};   // per service
+    long records = 0;
+    double peak_amount = 0.0;
+    double offpeak_amount = 0.0;
+    double discount = 0.0;       // volume tier discount
+    double total() const { return peak_amount + offpeak_amount - discount; }
+};
+
+struct RatingSummary {
+    long records = 0;
+    long units = 0;
+    double revenue = 0.0;
+    double peak_revenue = 0.0;
+    double offpeak_revenue = 0.0;
+    double discounts = 0.0;
+    double service_revenue[3] = {0.0, 0.0, 0.0};
+};
+
+// Tariff table: a rate per (technology, service, peak/off-peak) plus optional
+// volume tiers. The default reproduces the flat per-message prices
+// (5G $0.05, 4G $0.03, 2G/3G $0.01).
+class Tariff {
+public:
+    Tariff();
+    void load(const std::string &path);
+
+    double rate(int tech, int service, bool peak) const;
+    bool isPeak(uint32_t time_of_day_s) const;
+
+    struct Tier { long above_units; double multiplier; };
+    const std::vector<Tier> &tiers() const { return tiers_; }
+
+    static int techIndex(const std::string &name);
+    // Traffic class of a subscriber type: anything not data or voice rates as "both"
+    static int serviceIndex(const std::string &type);
+    // Tariff file service name (data/voice/both); throws InputError otherwise
+    static int parseService(const std::string &name);
+
+    // Flat table indexed by (tech * 3 + service) * 2 + peak
+    const double *table() const { return rates_; }
+    uint32_t peakStart() const { return peak_start_s_; }
+    uint32_t peakEnd() const { return peak_end_s_; }
+
+private:
+    double rates_[4 * 3 * 2];
+    uint32_t peak_start_s_;
+    uint32_t peak_end_s_;
+    std::vector<Tier> tiers_;
+};
+
+// Buffers usage records into struct-of-arrays batches and rates each batch in
+// tight loops the compiler can vectorise, accumulating per-subscriber invoices.
+// Not thread-safe: callers submitting from several threads must serialise.
+class RatingEngine {
+public:
+    explicit RatingEngine(size_t batch_size = 64 * 1024);
+
+    void setTariff(const Tariff &t);
+    const Tariff &tariff() const { return tariff_; }
+
+    void reset();
+    void submit(const UsageRecord &r);
+    // Aggregated usage: split into records of at most UINT16_MAX units.
+    // Throws InputError on a negative count.
+    void submitUsage(uint32_t subscriber_id, uint32_t time_of_day_s, uint8_t tech, uint8_t service, long units);
+
+    // Rates anything pending, applies volume tiers and returns invoices by id.
+    std::vector<Invoice> finalize(RatingSummary &summary);
+
+    static void printReport(const std::vector<Invoice> &invoices, const RatingSummary &s, size_t maxRows = 10);
+    static void writeCsv(const std::string &path, const std::vector<Invoice> &invoices);
+
+private:
+    void rateBatch();
+
+    Tariff tariff_;
+    size_t batch_size_;
+
+    // Pending batch, struct-of-arrays
+    std::vector<uint32_t> ids_;
+    std::vector<uint32_t> times_;
+    std::vector<uint8_t> classes_;   // tech * 3 + service
+    std::vector<uint16_t> units_;
+    // Scratch
+    std::vector<uint32_t> slot_;
+    std::vector<double> price_;
+
+    std::vector<Invoice> invoices_;  // dense, indexed by subscriber id
+    long records_;
+};
@@ -0,0 +1,227 @@
+#include "registry.h"
+#include "utils.h"
+
+#include <algorithm>
+#include <iterator>
+#include <functional>
+
+// --- PHONE INDEX ---
+
+static uint32_t phoneHash(const std::string &phone){ return (uint32_t)std::hash<std::string>()(phone); }
+
+void PhoneIndex::reserve(size_t n){
+    size_t cap = 16;
+    while (cap < 2 * n) cap <<= 1;   // load factor stays at or below 1/2
+    if (cap <= slots_.size()) return;
+    std::vector<Slot> old(cap, Slot{0, EMPTY});
+    old.swap(slots_);
+    size_t mask = slots_.size() - 1;
+    for (const Slot &e : old){
+        if (e.idx == EMPTY) continue;
+        size_t p = e.hash & mask;
+        while (slots_[p].idx != EMPTY) p = (p + 1) & mask;
+        slots_[p] = e;
+    }
+}
+
+void PhoneIndex::clear(){ slots_.clear(); used_ = 0; }
+
+size_t PhoneIndex::find(const std::string &phone, const std::vector<Subscriber> &roster) const {
+    if (slots_.empty()) return NONE;
+    uint32_t h = phoneHash(phone);
+    size_t mask = slots_.size() - 1;
+    for (size_t p = h & mask; slots_[p].idx != EMPTY; p = (p + 1) & mask)
+        if (slots_[p].hash == h && roster[slots_[p].idx].phone == phone) return slots_[p].idx;
+    return NONE;
+}
+
+bool PhoneIndex::insert(const std::string &phone, size_t idx, const std::vector<Subscriber> &roster){
+    if (2 * (used_ + 1) > slots_.size()) reserve(std::max<size_t>(used_ + 1, 2 * used_));
+    uint32_t h = phoneHash(phone);
+    size_t mask = slots_.size() - 1, p = h & mask;
+    for (; slots_[p].idx != EMPTY; p = (p + 1) & mask)
+        if (slots_[p].hash == h && roster[slots_[p].idx].phone == phone) return false;
+    slots_[p] = Slot{h, (uint32_t)idx};
+    used_++;
+    return true;
+}
+
+size_t PhoneIndex::probe(const std::string &phone, size_t idx) const {
+    size_t mask = slots_.size() - 1, p = phoneHash(phone) & mask;
+    while (slots_[p].idx != (uint32_t)idx) p = (p + 1) & mask;
+    return p;
+}
+
+void PhoneIndex::relocate(const std::string &phone, size_t from, size_t to){
+    slots_[probe(phone, from)].idx = (uint32_t)to;
+}
+
+void PhoneIndex::erase(const std::string &phone, size_t idx){
+    size_t mask = slots_.size() - 1, hole = probe(phone, idx);
+    // Backward-shift deletion: pull later entries of the cluster into the hole
+    // unless their home slot lies cyclically in (hole, p]
+    for (size_t p = (hole + 1) & mask; slots_[p].idx != EMPTY; p = (p + 1) & mask){
+        size_t home = slots_[p].hash & mask;
+        bool stays = hole <= p ? (home > hole && home <= p) : (home > hole || home <= p);
+        if (stays) continue;
+        slots_[hole] = slots_[p];
+        hole = p;
+    }
+    slots_[hole].idx = EMPTY;
+    used_--;
+}
+
+// --- REGISTRY ---
+
+static bool isDataType(const std::string &t){ return t == "data" || t == "Data" || t == "DATA"; }
+
+void SubscriberRegistry::count(const Subscriber &s, int sign){
+    if (isDataType(s.type)) stats_.data_users += sign; else stats_.voice_users += sign;
+    stats_.total_messages += sign * (long)s.messages;
+}
+
+size_t SubscriberRegistry::slotOf(int id) const {
+    if (id < 0 || (size_t)id >= byId_.size()) return NO_SLOT;
+    return byId_[id];
+}
+
+void SubscriberRegistry::add(const Subscriber &s){
+    if (s.id < 0) throw InputError("Invalid subscriber id " + std::to_string(s.id));
+    if (slotOf(s.id) != NO_SLOT) throw InputError("Duplicate subscriber id " + std::to_string(s.id));
+    size_t idx = subs_.size();
+    if (!s.phone.empty() && !byPhone_.insert(s.phone, idx, subs_))
+        throw InputError("Phone already registered: " + s.phone);
+    if ((size_t)s.id >= byId_.size()) byId_.resize((size_t)s.id + 1, NO_SLOT);
+    byId_[s.id] = idx;
+    subs_.push_back(s);
+    count(subs_.back(), +1);
+}
+
+size_t SubscriberRegistry::addAll(std::vector<Subscriber> &&batch){
+    size_t base = subs_.size();
+    if (base == 0) subs_.swap(batch);
+    else {
+        subs_.reserve(base + batch.size());
+        std::move(batch.begin(), batch.end(), std::back_inserter(subs_));
+    }
+    batch.clear();
+
+    int maxId = -1;
+    for (size_t i = base; i < subs_.size(); ++i) maxId = std::max(maxId, subs_[i].id);
+    if (maxId >= 0 && (size_t)maxId >= byId_.size()) byId_.resize((size_t)maxId + 1, NO_SLOT);
+    byPhone_.reserve(subs_.size());
+
+    // Index and compact in place: rejected entries are overwritten
+    size_t w = base;
+    for (size_t r = base; r < subs_.size(); ++r){
+        Subscriber &s = subs_[r];
+        if (s.id < 0 || byId_[s.id] != NO_SLOT) continue;
+        if (!s.phone.empty() && !byPhone_.insert(s.phone, w, subs_)) continue;
+        byId_[s.id] = w;
+        if (w != r) subs_[w] = std::move(s);
+        count(subs_[w], +1);
+        w++;
+    }
+    subs_.erase(subs_.begin() + w, subs_.end());
+    return w - base;
+}
+
+void SubscriberRegistry::reserve(size_t n){
+    subs_.reserve(n);
+    byPhone_.reserve(n);
+}
+
+Subscriber *SubscriberRegistry::find(int id){
+    size_t i = slotOf(id);
+    return i == NO_SLOT ? nullptr : &subs_[i];
+}
+
+const Subscriber *SubscriberRegistry::find(int id) const {
+    size_t i = slotOf(id);
+    return i == NO_SLOT ? nullptr : &subs_[i];
+}
+
+const Subscriber *SubscriberRegistry::findByPhone(const std::string &phone) const {
+    size_t i = byPhone_.find(phone, subs_);
+    return i == PhoneIndex::NONE ? nullptr : &subs_[i];
+}
+
+long SubscriberRegistry::indexOf(int id) const {
+    size_t i = slotOf(id);
+    return i == NO_SLOT ? -1 : (long)i;
+}
+
+void SubscriberRegistry::update(int id, const Subscriber &values){
+    size_t idx = slotOf(id);
+    if (idx == NO_SLOT) throw InputError("Unknown subscriber id " + std::to_string(id));
+    Subscriber &s = subs_[idx];
+
+    if (values.phone != s.phone){
+        if (!values.phone.empty() && byPhone_.find(values.phone, subs_) != PhoneIndex::NONE)
+            throw InputError("Phone already registered: " + values.phone);
+        if (!s.phone.empty()) byPhone_.erase(s.phone, idx);
+        s.phone = values.phone;
+        if (!s.phone.empty()) byPhone_.insert(s.phone, idx, subs_);
+    }
+    count(s, -1);
+    s.name = values.name;
+    s.phone = values.phone;
+    s.type = values.type;
+    s.messages = values.messages;
+    s.tech = values.tech;
+    count(s, +1);
+}
+
+void SubscriberRegistry::eraseAt(size_t idx){
+    size_t last = subs_.size() - 1;
+    count(subs_[idx], -1);
+    byId_[subs_[idx].id] = NO_SLOT;
+    if (!subs_[idx].phone.empty()) byPhone_.erase(subs_[idx].phone, idx);
+    if (idx != last){
+        subs_[idx] = std::move(subs_[last]);
+        byId_[subs_[idx].id] = idx;
+        if (!subs_[idx].phone.empty()) byPhone_.relocate(subs_[idx].phone, last, idx);
+    }
+    subs_.pop_back();
+}
+
+bool SubscriberRegistry::remove(int id, Subscriber *removed){
+    size_t idx = slotOf(id);
+    if (idx == NO_SLOT) return false;
+    if (removed) *removed = subs_[idx];
+    eraseAt(idx);
+    return true;
+}
+
+size_t SubscriberRegistry::removeIf(const std::function<bool(const Subscriber&)> &pred,
+                                    const std::function<void(const Subscriber&)> &onRemove){
+    size_t removed = 0;
+    // Walk backwards so the element swapped into a hole has already been visited.
+    for (size_t i = subs_.size(); i-- > 0; ){
+        if (!pred(subs_[i])) continue;
+        if (onRemove) onRemove(subs_[i]);
+        eraseAt(i);
+        removed++;
+    }
+    return removed;
+}
+
+size_t SubscriberRegistry::updateIf(const std::function<bool(const Subscriber&)> &pred,
+                                    const std::function<void(Subscriber&)> &apply){
+    size_t updated = 0;
+    for (auto &s : subs_){
+        if (!pred(s)) continue;
+        Subscriber next = s;
+        apply(next);
+        update(s.id, next); // id is the key and cannot be changed here
+        updated++;
+    }
+    return updated;
+}
+
+void SubscriberRegistry::clear(){
+    subs_.clear();
+    byId_.clear();
+    byPhone_.clear();
+    stats_ = RosterStats();
+}
@@ -0,0 +1,99 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <functional>
+#include <cstdint>
+#include "subscriber.h"
+
+// Running totals kept up to date on every add/update/remove, so dashboards
+// and status queries never rescan the roster.
+struct RosterStats {
+    long data_users = 0;
+    long voice_users = 0; // everything that is not data, as on the dashboard
+    long total_messages = 0;
+};
+
+// Open-addressing phone -> roster index map. Slots hold only the hash and the
+// roster index; keys are compared against the roster itself, so inserts do not
+// allocate per entry.
+class PhoneIndex {
+public:
+    static constexpr size_t NONE = (size_t)-1;
+
+    void reserve(size_t n);
+    void clear();
+    size_t find(const std::string &phone, const std::vector<Subscriber> &roster) const;
+    // False (and no change) if the phone is already present.
+    bool insert(const std::string &phone, size_t idx, const std::vector<Subscriber> &roster);
+    void erase(const std::string &phone, size_t idx);
+    void relocate(const std::string &phone, size_t from, size_t to);
+
+private:
+    static constexpr uint32_t EMPTY = UINT32_MAX;
+    struct Slot { uint32_t hash; uint32_t idx; };  // low 32 hash bits, enough for the mask
+    size_t probe(const std::string &phone, size_t idx) const; // slot holding idx
+
+    std::vector<Slot> slots_;
+    size_t used_ = 0;
+};
+
+// Owns the subscriber roster, indexed by id (dense: ids are handed out
+// sequentially) and by phone.
+// Storage stays a contiguous vector (CellTower::allocate works on it directly);
+// deletes swap the last element into the hole, so order is not preserved.
+class SubscriberRegistry {
+public:
+    // Throws InputError on a negative or duplicate id or a duplicate phone number.
+    void add(const Subscriber &s);
+    // Moves a whole batch in, skipping entries add() would reject; an empty
+    // roster adopts the batch's storage. Returns the number added.
+    size_t addAll(std::vector<Subscriber> &&batch);
+    void reserve(size_t n);
+
+    Subscriber *find(int id);
+    const Subscriber *find(int id) const;
+    const Subscriber *findByPhone(const std::string &phone) const;
+    long indexOf(int id) const; // -1 if absent
+
+    // Replaces name/phone/type/messages/tech of `id`, keeping the phone index
+    // consistent. Throws InputError if the id is unknown or the phone is taken.
+    void update(int id, const Subscriber &values);
+
+    // O(1) swap-remove. Returns false if the id is unknown.
+    bool remove(int id, Subscriber *removed = nullptr);
+
+    // Bulk operations; `onRemove` sees each subscriber before it is erased.
+    size_t removeIf(const std::function<bool(const Subscriber&)> &pred,
+                    const std::function<void(const Subscriber&)> &onRemove = nullptr);
+    size_t updateIf(const std::function<bool(const Subscriber&)> &pred,
+                    const std::function<void(Subscriber&)> &apply);
+
+    void clear();
+    size_t size() const { return subs_.size(); }
+    bool empty() const { return subs_.empty(); }
+    const RosterStats &stats() const { return stats_; }
+
+    // Mutable access is for allocation state (assigned_channel/dropped) only;
+    // edits to indexed or counted fields must go through update().
+    std::vector<Subscriber> &all() { return subs_; }
+    const std::vector<Subscriber> &all() const { return subs_; }
+    Subscriber &operator[](size_t i) { return subs_[i]; }
+    const Subscriber &operator[](size_t i) const { return subs_[i]; }
+
+    std::vector<Subscriber>::iterator begin() { return subs_.begin(); }
+    std::vector<Subscriber>::iterator end() { return subs_.end(); }
+    std::vector<Subscriber>::const_iterator begin() const { return subs_.begin(); }
+    std::vector<Subscriber>::const_iterator end() const { return subs_.end(); }
+
+private:
+    static constexpr size_t NO_SLOT = (size_t)-1;
+
+    size_t slotOf(int id) const;
+    void eraseAt(size_t idx);
+    void count(const Subscriber &s, int sign);
+
+    std::vector<Subscriber> subs_;
+    std::vector<size_t> byId_;  // id -> index in subs_, NO_SLOT if absent
+    PhoneIndex byPhone_;
+    RosterStats stats_;
+};
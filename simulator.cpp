@@ -4,6 +4,11 @@
 #include "technology.h"
 #include "celltower.h"
 #include "core.h"
+#include "planner.h"
+#include "tracereader.h"
+#include "generator.h"
+#include "timeline.h"
+#include "rating.h"
 #include "utils.h" // Colors are defined here now
 
 #include <iostream>
@@ -65,7 +70,8 @@ double Simulator::calculateCurrentLatency() const {
 // --- CORE SIMULATION ---
 
 void Simulator::allocateAndCompute(const std::string &outBase, bool fileMode){
-    tower_.allocate(subs_, allocation_strategy_);
+    TIMELINE_SCOPE("allocateAndCompute", "sim");
+    tower_.allocate(subs_.all(), allocation_strategy_);
     
     // Feature 1: Visual Spectrum Map
     std::cout << CYAN;
@@ -88,13 +94,23 @@ void Simulator::allocateAndCompute(const std::string &outBase, bool fileMode){
         total_messages_sent += s.messages;
     }
 
+    // Every transmitted message becomes a usage record for the rating engine
+    rating_.reset();
+    uint8_t techIdx = (uint8_t)Tariff::techIndex(tech_->name());
+
     // Launch Threads
+    {
+    TIMELINE_SCOPE("schedule devices", "device");
     for (auto &d : devices){
-        d->start([&](int msgNum){
+        uint8_t svc = (uint8_t)Tariff::serviceIndex(subs_.find(d->id())->type);
+        d->start([&, svc](int msgNum){
+            TIMELINE_SCOPE("tx", "message");
             std::lock_guard<std::mutex> lk(print_mtx);
             
             // Feature 2: Simulated Packet Loss
             bool dropped = (rand() % 100) < failureChance;
+            TIMELINE_INSTANT("interference", "message", "failed", dropped ? 1 : 0);
+            rating_.submit({(uint32_t)d->id(), localSecondsOfDay(), techIdx, svc, 1});
             
             std::cout << "[User " << std::setw(3) << d->id() << "] TX Packet " 
                       << std::setw(2) << msgNum << "/" << std::setw(2) << d->messages();
@@ -106,10 +122,14 @@ void Simulator::allocateAndCompute(const std::string &outBase, bool fileMode){
             }
         });
     }
+    }
 
+    {
+    TIMELINE_SCOPE("join devices", "device");
     for (auto &d : devices){
         d->join();
     }
+    }
     std::cout << "\n" << BOLD << "--- SIMULATION COMPLETE ---" << RESET << "\n";
 
     // --- NEW FEATURE: ASCII GRAPHICAL ANALYTICS (Block Style) ---
@@ -139,15 +159,23 @@ void Simulator::allocateAndCompute(const std::string &outBase, bool fileMode){
     }
     // -------------------------------------------------------
 
-    int overhead = core_.overheadFor(total_messages_sent);
-    int cores = core_.coresNeeded(total_messages_sent);
-    
-    // Feature 3: Billing System
-    double costPerMsg = 0.01;
-    if(tech_->name() == "5G") costPerMsg = 0.05;
-    else if(tech_->name() == "4G") costPerMsg = 0.03;
+    long overhead;
+    int cores;
+    {
+        TIMELINE_SCOPE("core accounting", "core");
+        overhead = core_.overheadFor(total_messages_sent);
+        cores = core_.coresNeeded(total_messages_sent);
+        TIMELINE_COUNTER("messages", total_messages_sent);
+        TIMELINE_COUNTER("cores", cores);
+    }
     
-    double totalRevenue = total_messages_sent * costPerMsg;
+    // Feature 3: Billing System (rated per message against the tariff table)
+    RatingSummary billing;
+    std::vector<Invoice> invoices;
+    {
+        TIMELINE_SCOPE("rating", "billing");
+        invoices = rating_.finalize(billing);
+    }
 
     std::cout << CYAN << "------------------------------------------\n";
     std::cout << " ANALYTICS & BILLING REPORT\n";
@@ -157,18 +185,20 @@ void Simulator::allocateAndCompute(const std::string &outBase, bool fileMode){
     std::cout << " Total Traffic Load       : " << (total_messages_sent + overhead) << " msgs\n";
     std::cout << " Cellular Cores Active    : " << cores << "\n";
     std::cout << " Avg Network Latency      : " << calculateCurrentLatency() << " ms\n";
-    std::cout << " Revenue Generated        : " << GREEN << "$" << std::fixed << std::setprecision(2) << totalRevenue << RESET << " (@ $" << costPerMsg << "/msg)\n";
+    RatingEngine::printReport(invoices, billing);
     std::cout << CYAN << "------------------------------------------" << RESET << "\n";
     
     if (fileMode) {
         std::ofstream f(outBase);
-        if(f) f << "Report\nTotal Msg: " << total_messages_sent << "\n";
+        if(f) f << "Report\nTotal Msg: " << total_messages_sent << "\nRevenue: " << billing.revenue << "\n";
+        RatingEngine::writeCsv("invoices.csv", invoices);
     }
 }
 
 // --- FILE PARSING ---
 
-void Simulator::parseConfig(const std::string &path){
+void Simulator::parseConfig(const std::string &path, ImportChecks checks){
+    TIMELINE_SCOPE("parseConfig", "parse");
     std::ifstream f(path);
     if (!f) throw InputError("Cannot open config file: " + path);
     std::string line;
@@ -183,6 +213,19 @@ void Simulator::parseConfig(const std::string &path){
         if (key == "technology") { tech_ = makeTech(val); tower_.setTechnology(tech_); }
         else if (key == "bandwidth_mhz") { bandwidth_mhz_ = to_double(val); tower_.setBandwidth(bandwidth_mhz_); }
         else if (key == "antennas") { antennas_ = to_int(val); tower_.setAntennas(antennas_); }
+        else if (key == "tariff") { Tariff t; t.load(val); rating_.setTariff(t); }
+        else if (key.find("carrier") == 0) {
+            std::string t; double bw = 0.0; int ant = 1;
+            std::stringstream ss(val);
+            std::string segment;
+            while(std::getline(ss, segment, ',')){
+                auto c = segment.find(':');
+                if (c == std::string::npos) continue;
+                std::string k = trim(segment.substr(0,c)), v = trim(segment.substr(c+1));
+                if (k=="tech") t=v; else if (k=="bandwidth") bw=to_double(v); else if (k=="antennas") ant=to_int(v);
+            }
+            site_.addCarrier(makeTech(t), bw, ant);
+        }
         else if (key.find("user") == 0) {
             Subscriber s; s.id = next_id_++; s.dropped=false; s.assigned_channel=-1;
             std::stringstream ss(val);
@@ -193,13 +236,14 @@ void Simulator::parseConfig(const std::string &path){
                 std::string k = trim(segment.substr(0,c)), v = trim(segment.substr(c+1));
                 if (k=="name") s.name=v; else if (k=="phone") s.phone=v;
                 else if (k=="type") s.type=v; else if (k=="msg") s.messages=to_int(v);
+                else if (k=="tech") s.tech=v;
             }
             try {
                 if(!isValidName(s.name)) throw std::runtime_error("Invalid Name (Letters only)");
                 if(!isValidPhone(s.phone)) throw std::runtime_error("Invalid Phone (Digits only)");
-                if (subs_.size() >= (size_t)tower_.totalCapacity()) throw std::runtime_error("Capacity Reached");
-                tech_->validate_usage(s.type, s.messages);
-                subs_.push_back(s);
+                if (checks == ImportChecks::All && subs_.size() >= (size_t)tower_.totalCapacity()) throw std::runtime_error("Capacity Reached");
+                if (checks != ImportChecks::None) tech_->validate_usage(s.type, s.messages);
+                subs_.add(s);
             } catch (const std::exception &e) { std::cerr << RED << "Import Error ID " << s.id << ": " << e.what() << RESET << "\n"; }
         }
     }
@@ -210,17 +254,214 @@ void Simulator::runFromFile(const std::string &path){
     allocateAndCompute("output_report.csv", true);
 }
 
+// --- CAPACITY PLANNER ---
+
+void Simulator::planFromFile(const std::string &path, double targetDropRate){
+    // The roster is what we are sizing for: skip the current tower's capacity
+    // and usage checks, the planner applies them per technology.
+    parseConfig(path, ImportChecks::None);
+    CapacityPlanner planner(core_);
+    planner.setDemand(subs_.all());
+    std::cout << "Planning for " << planner.totalSubscribers() << " subscribers from " << path << "\n";
+    CapacityPlanner::printPlan(planner.plan(targetDropRate), targetDropRate);
+}
+
+void Simulator::planProjection(long subscribers, const std::string &type, int messages, double targetDropRate){
+    CapacityPlanner planner(core_);
+    planner.setProjection(subscribers, type, messages);
+    std::cout << "Planning for projection: " << subscribers << " x " << type << " @ " << messages << " msgs\n";
+    CapacityPlanner::printPlan(planner.plan(targetDropRate), targetDropRate);
+}
+
+// --- MULTI-CARRIER SITE ---
+
+void Simulator::runSite(const std::string &path){
+    site_.clear();
+    // Each carrier applies its own capacity and usage limits during admission
+    parseConfig(path, ImportChecks::None);
+    if (site_.carrierCount() == 0) throw InputError("No carrier= lines in " + path);
+
+    auto t0 = std::chrono::steady_clock::now();
+    SiteReport r;
+    rating_.reset();
+    {
+        TIMELINE_SCOPE("site admit", "allocate");
+        site_.admit(subs_.all(), allocation_strategy_);
+    }
+    {
+        TIMELINE_SCOPE("site simulate", "sim");
+        r = site_.simulate(core_, rating_);
+    }
+    RatingSummary billing;
+    std::vector<Invoice> invoices;
+    {
+        TIMELINE_SCOPE("rating", "billing");
+        invoices = rating_.finalize(billing);
+    }
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    Site::printReport(r);
+    std::cout << " Site Cycle Time          : " << std::fixed << std::setprecision(3) << secs << " s\n";
+    RatingEngine::printReport(invoices, billing);
+    std::cout << CYAN << "------------------------------------------------------------------------------------" << RESET << "\n";
+}
+
+// --- SYNTHETIC WORKLOAD ---
+
+void Simulator::generateWorkload(const std::string &specPath, const std::string &outPath){
+    parseConfig(specPath);
+    WorkloadGenerator gen(WorkloadGenerator::loadSpec(specPath));
+    auto t0 = std::chrono::steady_clock::now();
+
+    if (!outPath.empty()){
+        {
+            std::ofstream f(outPath, std::ios::trunc);
+            if (!f) throw InputError("Cannot write workload file: " + outPath);
+            f << "# Generated from " << specPath << "\n";
+            f << "technology=" << tech_->name() << "\n";
+            f << "bandwidth_mhz=" << bandwidth_mhz_ << "\n";
+            f << "antennas=" << antennas_ << "\n";
+        }
+        gen.writeUsers(outPath, 1);
+        double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        std::cout << GREEN << "-> Workload written to " << outPath << " in " << std::fixed
+                  << std::setprecision(2) << secs << " s" << RESET << "\n";
+        return;
+    }
+
+    std::vector<Subscriber> generated;
+    gen.generate(generated, next_id_);
+    next_id_ += (int)generated.size();
+    long total = (long)generated.size();
+
+    // Devices are generated against their own technology's limits; users this
+    // tower's technology would reject at import are left out, as parseConfig does.
+    auto over = std::remove_if(generated.begin(), generated.end(), [this](const Subscriber &s){
+        int lim = tech_->max_messages(s.type);
+        return lim <= 0 || s.messages > lim;
+    });
+    long rejected = (long)(generated.end() - over);
+    generated.erase(over, generated.end());
+
+    long offered = (long)generated.size();
+    long duplicates = offered - (long)subs_.addAll(std::move(generated));
+    double gen_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    tower_.allocate(subs_.all(), allocation_strategy_);
+
+    std::map<std::string, long> byTech, byType;
+    long dropped = 0, msgs = 0;
+    for (const auto &s : subs_){
+        byTech[s.tech.empty() ? "-" : s.tech]++;
+        byType[s.type]++;
+        if (s.dropped) dropped++; else msgs += s.messages;
+    }
+
+    std::cout << CYAN << "------------------------------------------\n";
+    std::cout << " SYNTHETIC WORKLOAD REPORT\n";
+    std::cout << "------------------------------------------" << RESET << "\n";
+    std::cout << " Subscribers Generated    : " << total << " in " << std::fixed
+              << std::setprecision(2) << gen_s << " s\n";
+    std::cout << " Device Technology Mix    :";
+    for (const auto &t : byTech) std::cout << " " << t.first << "=" << t.second;
+    std::cout << "\n Traffic Type Mix         :";
+    for (const auto &t : byType) std::cout << " " << t.first << "=" << t.second;
+    std::cout << "\n Admitted / Capacity      : " << (long)subs_.size() - dropped << " / " << tower_.totalCapacity() << "\n";
+    std::cout << " Dropped (Over Capacity)  : " << dropped << "\n";
+    if (rejected) std::cout << YELLOW << " Rejected (Tower Limits)  : " << rejected << RESET << "\n";
+    if (duplicates) std::cout << YELLOW << " Skipped (Duplicate Phone): " << duplicates << RESET << "\n";
+    std::cout << " Offered Messages         : " << msgs << " -> " << core_.coresNeeded(msgs) << " cores\n";
+    std::cout << CYAN << "------------------------------------------" << RESET << "\n";
+}
+
+// --- TRACE REPLAY ---
+
+void Simulator::replayTrace(const std::string &configPath, const std::string &tracePath, double speed){
+    if (speed < 0.0) throw InputError("Replay speed cannot be negative");
+    // Keep over-capacity users in the roster so the tower blocks their traffic
+    parseConfig(configPath, ImportChecks::SkipCapacity);
+    tower_.allocate(subs_.all(), allocation_strategy_);
+
+    std::vector<long> sent(subs_.size(), 0);
+
+    TraceReader reader(tracePath);
+    std::cout << "\n" << BOLD << "--- REPLAYING TRACE " << tracePath << " ("
+              << (reader.isBinary() ? "binary" : "csv") << ", "
+              << (speed > 0.0 ? std::to_string(speed) + "x" : std::string("max speed")) << ") ---" << RESET << "\n";
+
+    long delivered = 0, blocked = 0, unknown = 0, over_quota = 0;
+    // Peak load is tracked over 1-second windows of trace time
+    long window_msgs = 0, peak_window_msgs = 0;
+    int64_t window_start = 0, first_ts = 0, last_ts = 0;
+    bool first = true;
+    auto wall_start = std::chrono::steady_clock::now();
+
+    // Trace timestamps are taken as ms since midnight of day 0 for peak/off-peak
+    rating_.reset();
+    uint8_t techIdx = (uint8_t)Tariff::techIndex(tech_->name());
+
+    TIMELINE_SCOPE("replay", "replay");
+    TraceEvent ev;
+    while (reader.next(ev)){
+        if (first){ first_ts = window_start = ev.timestamp_ms; first = false; }
+        last_ts = ev.timestamp_ms;
+
+        if (speed > 0.0){
+            auto due = wall_start + std::chrono::microseconds((int64_t)((ev.timestamp_ms - first_ts) * 1000.0 / speed));
+            std::this_thread::sleep_until(due);
+        }
+
+        if (ev.timestamp_ms - window_start >= 1000){
+            TIMELINE_COUNTER("replay msgs/s", window_msgs);
+            TIMELINE_COUNTER("replay cores", core_.coresNeeded(window_msgs));
+            peak_window_msgs = std::max(peak_window_msgs, window_msgs);
+            window_msgs = 0;
+            window_start = ev.timestamp_ms - (ev.timestamp_ms - window_start) % 1000;
+        }
+
+        long idx = subs_.indexOf(ev.user_id);
+        if (idx < 0){ unknown++; continue; }
+        const Subscriber &s = subs_[idx];
+        if (s.dropped){ blocked++; continue; }
+
+        if (++sent[idx] > s.messages) over_quota++;
+        delivered++;
+        rating_.submit({(uint32_t)s.id, (uint32_t)((ev.timestamp_ms / 1000) % 86400), techIdx,
+                        (uint8_t)Tariff::serviceIndex(s.type), 1});
+        window_msgs++;
+    }
+    peak_window_msgs = std::max(peak_window_msgs, window_msgs);
+    double wall_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_start).count();
+
+    long overhead = core_.overheadFor(delivered);
+    std::cout << CYAN << "------------------------------------------\n";
+    std::cout << " TRACE REPLAY REPORT\n";
+    std::cout << "------------------------------------------" << RESET << "\n";
+    std::cout << " Trace Events Read        : " << reader.eventsRead() << "\n";
+    std::cout << " Trace Duration           : " << std::fixed << std::setprecision(3) << (last_ts - first_ts) / 1000.0 << " s\n";
+    std::cout << " Replay Wall Time         : " << wall_s << " s\n";
+    std::cout << " Messages Delivered       : " << delivered << "\n";
+    std::cout << " Blocked (No Channel)     : " << blocked << "\n";
+    std::cout << " Unknown Subscriber       : " << unknown << "\n";
+    std::cout << " Over Subscriber Quota    : " << over_quota << "\n";
+    std::cout << " Network Overhead         : " << overhead << " msgs\n";
+    std::cout << " Cellular Cores (Total)   : " << core_.coresNeeded(delivered) << "\n";
+    std::cout << " Peak 1s Window           : " << peak_window_msgs << " msgs -> "
+              << core_.coresNeeded(peak_window_msgs) << " cores\n";
+    RatingSummary billing;
+    std::vector<Invoice> invoices = rating_.finalize(billing);
+    RatingEngine::printReport(invoices, billing);
+    std::cout << CYAN << "------------------------------------------" << RESET << "\n";
+}
+
 // --- INTERACTIVE MENU ---
 
 void Simulator::menuLoop(){
     while(true){
-        tower_.allocate(subs_, allocation_strategy_); 
+        // Counters are maintained by the registry; allocation happens on Run
         int total_cap = tower_.totalCapacity();
         int users = subs_.size();
-        int data_users = 0, voice_users = 0;
-        for(const auto& s : subs_) {
-            if(s.type == "data" || s.type == "Data" || s.type == "DATA") data_users++; else voice_users++;
-        }
+        long data_users = subs_.stats().data_users, voice_users = subs_.stats().voice_users;
         
         double load_pct = (total_cap > 0) ? ((double)users / total_cap) * 100.0 : 0.0;
         double latency = calculateCurrentLatency();
@@ -259,7 +500,14 @@ void Simulator::menuLoop(){
         if (cmd == "1") interactiveConfigure();
         else if (cmd == "2") interactiveAddUser();
         else if (cmd == "3") interactiveListUsers();
-        else if (cmd == "4") interactiveEditUser();
+        else if (cmd == "4") {
+            std::string sub;
+            std::cout << " (E)dit user | (D)elete user(s) | (B)ulk update > "; std::cin >> sub;
+            if (sub == "E" || sub == "e") interactiveEditUser();
+            else if (sub == "D" || sub == "d") interactiveDeleteUsers();
+            else if (sub == "B" || sub == "b") interactiveBulkUpdate();
+            else std::cout << RED << "Invalid command." << RESET << "\n";
+        }
         else if (cmd == "5") allocateAndCompute("report.txt", false);
         else if (cmd == "6") { 
             subs_.clear(); next_id_ = 1; 
@@ -304,6 +552,10 @@ void Simulator::interactiveAddUser(){
             std::cout << RED << "!!! FAILURE: Invalid Phone '" << s.phone << "'. Must contain ONLY digits." << RESET << "\n";
             next_id_--; continue;
         }
+        if(subs_.findByPhone(s.phone)) {
+            std::cout << RED << "!!! FAILURE: Phone '" << s.phone << "' is already registered." << RESET << "\n";
+            next_id_--; continue;
+        }
 
         std::cout << " Type (data/voice)  : "; std::cin >> s.type;
         std::cout << " Msg Count          : "; std::cin >> s.messages;
@@ -314,7 +566,7 @@ void Simulator::interactiveAddUser(){
         
         try {
             tech_->validate_usage(s.type, s.messages);
-            subs_.push_back(s);
+            subs_.add(s);
             std::cout << GREEN << "-> User " << s.name << " added successfully." << RESET << "\n";
         } catch (std::exception &e) {
             std::cout << RED << "!!! FAILURE: " << e.what() << RESET << "\n"; next_id_--;
@@ -353,8 +605,8 @@ void Simulator::interactiveEditUser(){
     std::cout << "Enter User ID to edit: "; 
     std::cin >> id;
     
-    auto it = std::find_if(subs_.begin(), subs_.end(), [id](const Subscriber& s){ return s.id == id; });
-    if (it == subs_.end()) { std::cout << "User ID not found.\n"; return; }
+    Subscriber *it = subs_.find(id);
+    if (!it) { std::cout << "User ID not found.\n"; return; }
     
     std::cout << "Editing User: " << it->name << "\n";
     std::string n, p, t; int m;
@@ -370,9 +622,68 @@ void Simulator::interactiveEditUser(){
 
     try {
         tech_->validate_usage(t, m);
-        it->name = n; it->phone = p; it->type = t; it->messages = m;
+        Subscriber updated = *it;
+        updated.name = n; updated.phone = p; updated.type = t; updated.messages = m;
+        subs_.update(id, updated);
         std::cout << GREEN << "-> User updated successfully." << RESET << "\n";
     } catch (std::exception &e) {
         std::cout << RED << "!!! FAILURE: " << e.what() << RESET << "\n";
     }
-}
\ No newline at end of file
+}
+
+size_t Simulator::deleteUsersIf(const std::function<bool(const Subscriber&)> &pred){
+    return subs_.removeIf(pred, [this](const Subscriber &s){
+        if (!s.dropped) tower_.release(s.id, s.assigned_channel);
+    });
+}
+
+bool Simulator::deleteUser(int id){
+    Subscriber gone;
+    if (!subs_.remove(id, &gone)) return false;
+    if (!gone.dropped) tower_.release(gone.id, gone.assigned_channel);
+    return true;
+}
+
+void Simulator::interactiveDeleteUsers(){
+    std::string by;
+    std::cout << "Delete by (id/phone/type/tech/dropped): "; std::cin >> by;
+
+    size_t removed = 0;
+    if (by == "id" || by == "phone") {
+        int id = -1;
+        if (by == "id") { std::cout << "User ID: "; std::cin >> id; }
+        else {
+            std::string p; std::cout << "Phone: "; std::cin >> p;
+            if (const Subscriber *s = subs_.findByPhone(p)) id = s->id;
+        }
+        removed = deleteUser(id) ? 1 : 0;
+    } else if (by == "type") {
+        std::string t; std::cout << "Type: "; std::cin >> t;
+        removed = deleteUsersIf([&t](const Subscriber &s){ return s.type == t; });
+    } else if (by == "tech") {
+        std::string t; std::cout << "Device Tech: "; std::cin >> t;
+        removed = deleteUsersIf([&t](const Subscriber &s){ return s.tech == t; });
+    } else if (by == "dropped") {
+        removed = deleteUsersIf([](const Subscriber &s){ return s.dropped; });
+    } else {
+        std::cout << RED << "!!! FAILURE: Unknown selector '" << by << "'." << RESET << "\n";
+        return;
+    }
+
+    if (removed == 0) std::cout << YELLOW << "-> No matching users." << RESET << "\n";
+    else std::cout << GREEN << "-> Deleted " << removed << " user(s)." << RESET << "\n";
+}
+
+void Simulator::interactiveBulkUpdate(){
+    std::string t; int m;
+    std::cout << "Set message count for all users of type: "; std::cin >> t;
+    std::cout << "New Msgs : "; std::cin >> m;
+    try {
+        tech_->validate_usage(t, m);
+        size_t n = subs_.updateIf([&t](const Subscriber &s){ return s.type == t; },
+                                  [m](Subscriber &s){ s.messages = m; });
+        std::cout << GREEN << "-> Updated " << n << " user(s)." << RESET << "\n";
+    } catch (std::exception &e) {
+        std::cout << RED << "!!! FAILURE: " << e.what() << RESET << "\n";
+    }
+}
@@ -2,10 +2,14 @@
 #include <vector>
 #include <string>
 #include <memory>
+#include <functional>
 #include "technology.h"
 #include "celltower.h"
 #include "core.h"
 #include "subscriber.h"
+#include "registry.h"
+#include "site.h"
+#include "rating.h"
 
 class Simulator {
 public:
@@ -13,9 +17,30 @@ public:
     void menuLoop();
     void runFromFile(const std::string &path);
 
+    // --- CAPACITY PLANNER ---
+    void planFromFile(const std::string &path, double targetDropRate);
+    void planProjection(long subscribers, const std::string &type, int messages, double targetDropRate);
+
+    // --- MULTI-CARRIER SITE ---
+    // Config adds carrier=tech:<2G..5G>,bandwidth:<MHz>,antennas:<n> lines
+    void runSite(const std::string &path);
+
+    // --- SYNTHETIC WORKLOAD ---
+    // Empty outPath generates in memory and allocates; otherwise writes a config file.
+    void generateWorkload(const std::string &specPath, const std::string &outPath);
+
+    // --- TRACE REPLAY ---
+    // speed: 1.0 = real time, N = N x faster, 0 = as fast as possible
+    void replayTrace(const std::string &configPath, const std::string &tracePath, double speed);
+
 private:
+    friend class HeadlessController;
+
+    // Which per-user checks parseConfig applies against the current tower
+    enum class ImportChecks { All, SkipCapacity, None };
+
     std::shared_ptr<Technology> makeTech(const std::string &name);
-    void parseConfig(const std::string &path);
+    void parseConfig(const std::string &path, ImportChecks checks = ImportChecks::All);
     void allocateAndCompute(const std::string &outBase, bool fileMode);
 
     // --- INTERACTIVE ACTIONS ---
@@ -23,6 +48,13 @@ private:
     void interactiveAddUser();
     void interactiveListUsers();
     void interactiveEditUser(); // Added back
+    void interactiveDeleteUsers();
+    void interactiveBulkUpdate();
+
+    // Removes users and frees their channels. deleteUser is an O(1) index
+    // lookup; deleteUsersIf scans the roster and returns the count removed.
+    bool deleteUser(int id);
+    size_t deleteUsersIf(const std::function<bool(const Subscriber&)> &pred);
     
     // --- HELPER FOR REALISM ---
     std::string getSignalQuality(int userId) const;
@@ -32,7 +64,9 @@ private:
     std::shared_ptr<Technology> tech_;
     CellTower tower_;
     CellularCore core_;
-    std::vector<Subscriber> subs_;
+    Site site_;
+    RatingEngine rating_;
+    SubscriberRegistry subs_;
     double bandwidth_mhz_;
     int antennas_;
     int overhead_per_100_;
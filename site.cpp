@@ -0,0 +1,208 @@
+#include "site.h"
+#include "utils.h"
+#include "timeline.h"
+
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+#include <random>
+#include <algorithm>
+
+Site::Site() : subscribers_(0), blocked_full_(0), blocked_incompatible_(0) {}
+
+void Site::addCarrier(std::shared_ptr<Technology> tech, double bw_mhz, int antennas){
+    if (bw_mhz <= 0.0) throw InputError("Carrier bandwidth must be positive");
+    if (antennas < 1 || antennas > tech->max_antennas())
+        throw InputError(tech->name() + " carrier supports 1 to " + std::to_string(tech->max_antennas()) + " antennas");
+    auto c = std::make_unique<Carrier>();
+    c->tech = tech;
+    c->bandwidth_mhz = bw_mhz;
+    c->antennas = antennas;
+    c->tower.setTechnology(tech);
+    c->tower.setBandwidth(bw_mhz);
+    c->tower.setAntennas(antennas);
+    c->overflow_in = 0;
+    carriers_.push_back(std::move(c));
+}
+
+void Site::clear(){ carriers_.clear(); subscribers_ = blocked_full_ = blocked_incompatible_ = 0; }
+size_t Site::carrierCount() const { return carriers_.size(); }
+
+// "2G" -> 2 ... "5G" -> 5; devices with no declared technology take any carrier
+int Site::generation(const std::string &tech){
+    if (tech.size() == 2 && tech[1] == 'G' && tech[0] >= '2' && tech[0] <= '5') return tech[0] - '0';
+    return 99;
+}
+
+void Site::admit(std::vector<Subscriber> &subs, const std::string &strategy){
+    if (carriers_.empty()) throw InputError("Site has no carriers configured");
+
+    // Newest technology first; carriers of the same generation stay in config order
+    std::vector<size_t> order(carriers_.size());
+    for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [this](size_t a, size_t b){
+        return generation(carriers_[a]->tech->name()) > generation(carriers_[b]->tech->name());
+    });
+
+    std::vector<long> remaining(carriers_.size());
+    for (size_t i = 0; i < carriers_.size(); ++i){
+        auto &c = *carriers_[i];
+        remaining[i] = c.tower.totalCapacity();
+        c.members.clear();
+        c.origin.clear();
+        c.overflow_in = 0;
+    }
+    subscribers_ = (long)subs.size();
+    blocked_full_ = blocked_incompatible_ = 0;
+
+    for (size_t si = 0; si < subs.size(); ++si){
+        Subscriber &s = subs[si];
+        s.dropped = false;
+        s.assigned_channel = -1;
+        int devGen = generation(s.tech);
+
+        long best = -1;
+        int bestGen = -1, fullGen = -1;
+        bool compatible = false;
+        for (size_t k : order){
+            const Carrier &c = *carriers_[k];
+            int g = generation(c.tech->name());
+            if (g > devGen) continue;
+            if (s.messages > c.tech->max_messages(s.type)) continue;
+            compatible = true;
+            if (best >= 0 && g < bestGen) break; // only compare equals of the best generation
+            if (remaining[k] <= 0){ fullGen = std::max(fullGen, g); continue; }
+            if (best < 0){ best = (long)k; bestGen = g; continue; }
+            // Same generation: least utilised wins
+            double ub = 1.0 - (double)remaining[best] / std::max(1, carriers_[best]->tower.totalCapacity());
+            double uk = 1.0 - (double)remaining[k] / std::max(1, c.tower.totalCapacity());
+            if (uk < ub) best = (long)k;
+        }
+
+        if (best < 0){
+            s.dropped = true;
+            if (compatible) blocked_full_++; else blocked_incompatible_++;
+            continue;
+        }
+        Carrier &c = *carriers_[best];
+        remaining[best]--;
+        if (fullGen > bestGen) c.overflow_in++;
+        c.members.push_back(s);
+        c.origin.push_back(si);
+    }
+
+    // Every member fits, so the per-carrier allocations are independent
+    std::vector<std::thread> pool;
+    for (auto &cp : carriers_){
+        Carrier *c = cp.get();
+        pool.emplace_back([c, &strategy](){
+            TIMELINE_NAME_THREAD("Carrier " + c->tech->name());
+            c->tower.allocate(c->members, strategy);
+        });
+    }
+    for (auto &t : pool) t.join();
+
+    for (auto &cp : carriers_){
+        for (size_t i = 0; i < cp->members.size(); ++i){
+            Subscriber &s = subs[cp->origin[i]];
+            s.assigned_channel = cp->members[i].assigned_channel;
+            s.dropped = cp->members[i].dropped;
+        }
+    }
+}
+
+SiteReport Site::simulate(const CellularCore &core, RatingEngine &rating) const {
+    SiteReport r;
+    r.subscribers = subscribers_;
+    r.blocked_full = blocked_full_;
+    r.blocked_incompatible = blocked_incompatible_;
+    r.carriers.resize(carriers_.size());
+
+    std::vector<std::thread> pool;
+    for (size_t i = 0; i < carriers_.size(); ++i){
+        pool.emplace_back([this, i, &r, &core](){
+            TIMELINE_SCOPE("carrier simulate", "sim");
+            const Carrier &c = *carriers_[i];
+            CarrierReport &cr = r.carriers[i];
+            cr.tech = c.tech->name();
+            cr.bandwidth_mhz = c.bandwidth_mhz;
+            cr.antennas = c.antennas;
+            cr.capacity = c.tower.totalCapacity();
+            cr.overflow_in = c.overflow_in;
+
+            // Same load-dependent interference model as the single-tower run
+            double load = cr.capacity > 0 ? (double)c.members.size() / cr.capacity : 0.0;
+            int failureChance = (int)(load * 30.0);
+            std::mt19937 rng((unsigned)(i + 1));
+            for (const auto &s : c.members){
+                if (s.dropped) continue;
+                cr.admitted++;
+                cr.messages += s.messages;
+                for (int m = 0; m < s.messages; ++m) if ((int)(rng() % 100) < failureChance) cr.retries++;
+            }
+            cr.cores = core.coresNeeded(cr.messages);
+        });
+    }
+    for (auto &t : pool) t.join();
+
+    // RatingEngine is not thread-safe: rate after the join, in carrier order
+    uint32_t now = localSecondsOfDay();
+    for (const auto &cp : carriers_){
+        uint8_t t = (uint8_t)Tariff::techIndex(cp->tech->name());
+        for (const auto &s : cp->members){
+            if (s.dropped) continue;
+            rating.submitUsage((uint32_t)s.id, now, t, (uint8_t)Tariff::serviceIndex(s.type), s.messages);
+        }
+    }
+
+    for (const auto &cr : r.carriers){ r.admitted += cr.admitted; r.messages += cr.messages; }
+    r.cores = core.coresNeeded(r.messages);
+    return r;
+}
+
+void Site::printReport(const SiteReport &r){
+    std::cout << "\n" << CYAN << "--- MULTI-CARRIER SITE REPORT ---" << RESET << "\n";
+    std::cout << std::left << std::setw(4) << "#"
+              << std::setw(6) << "Tech"
+              << std::setw(12) << "Bandwidth"
+              << std::setw(6) << "MIMO"
+              << std::setw(18) << "Admitted/Cap"
+              << std::setw(8) << "Util%"
+              << std::setw(10) << "Overflow"
+              << std::setw(10) << "Msgs"
+              << std::setw(9) << "Retries"
+              << "Cores" << "\n";
+    std::cout << "------------------------------------------------------------------------------------\n";
+
+    long totalCap = 0;
+    for (size_t i = 0; i < r.carriers.size(); ++i){
+        const CarrierReport &c = r.carriers[i];
+        totalCap += c.capacity;
+        double util = c.capacity > 0 ? 100.0 * c.admitted / c.capacity : 0.0;
+        std::string col = util > 90.0 ? RED : (util > 75.0 ? YELLOW : GREEN);
+        std::ostringstream bw, ant, occ;
+        bw << std::fixed << std::setprecision(2) << c.bandwidth_mhz << " MHz";
+        ant << c.antennas << "x";
+        occ << c.admitted << "/" << c.capacity;
+        std::cout << std::left << std::setw(4) << (i + 1)
+                  << std::setw(6) << c.tech
+                  << std::setw(12) << bw.str()
+                  << std::setw(6) << ant.str()
+                  << std::setw(18) << occ.str()
+                  << col << std::setw(8) << std::fixed << std::setprecision(1) << util << RESET
+                  << std::setw(10) << c.overflow_in
+                  << std::setw(10) << c.messages
+                  << std::setw(9) << c.retries
+                  << c.cores << "\n";
+    }
+    std::cout << "------------------------------------------------------------------------------------\n";
+    double util = totalCap > 0 ? 100.0 * r.admitted / totalCap : 0.0;
+    std::cout << " Site Utilization         : " << r.admitted << " / " << totalCap
+              << " (" << std::fixed << std::setprecision(1) << util << "%)\n";
+    std::cout << " Subscribers              : " << r.subscribers << "\n";
+    std::cout << " Blocked (All Full)       : " << r.blocked_full << "\n";
+    std::cout << " Blocked (No Compatible)  : " << r.blocked_incompatible << "\n";
+    std::cout << " Total Messages           : " << r.messages << "\n";
+    std::cout << " Shared Core Cores        : " << r.cores << "\n";
+}
@@ -0,0 +1,70 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <memory>
+#include "technology.h"
+#include "celltower.h"
+#include "core.h"
+#include "subscriber.h"
+#include "rating.h"
+
+struct CarrierReport {
+    std::string tech;
+    double bandwidth_mhz = 0.0;
+    int antennas = 0;
+    int capacity = 0;
+    long admitted = 0;
+    long overflow_in = 0;   // admitted here after a better carrier was full
+    long messages = 0;
+    long retries = 0;       // interference failures, retried
+    int cores = 0;
+};
+
+struct SiteReport {
+    std::vector<CarrierReport> carriers;
+    long subscribers = 0;
+    long admitted = 0;
+    long blocked_full = 0;          // compatible carriers exist but all are full
+    long blocked_incompatible = 0;  // no carrier the device/usage can use
+    long messages = 0;
+    int cores = 0;                  // shared core sized for the whole site
+};
+
+// A co-located site hosting several CellTower carriers of different
+// technologies. Each subscriber is admitted to the newest carrier its device
+// supports (least loaded among equals) and overflows to older ones when full.
+class Site {
+public:
+    Site();
+    void addCarrier(std::shared_ptr<Technology> tech, double bw_mhz, int antennas);
+    void clear();
+    size_t carrierCount() const;
+
+    // Admission is sequential; per-carrier channel allocation runs in parallel.
+    // Writes dropped/assigned_channel back into `subs`.
+    void admit(std::vector<Subscriber> &subs, const std::string &strategy);
+
+    // Per-carrier traffic + core accounting, one thread per carrier. Admitted
+    // usage is then rated at each carrier's technology rates.
+    SiteReport simulate(const CellularCore &core, RatingEngine &rating) const;
+
+    static void printReport(const SiteReport &r);
+
+private:
+    struct Carrier {
+        std::shared_ptr<Technology> tech;
+        double bandwidth_mhz;
+        int antennas;
+        CellTower tower;
+        std::vector<Subscriber> members;
+        std::vector<size_t> origin;  // index of each member in the admitted roster
+        long overflow_in;
+    };
+
+    static int generation(const std::string &tech);
+
+    std::vector<std::unique_ptr<Carrier>> carriers_;
+    long subscribers_;
+    long blocked_full_;
+    long blocked_incompatible_;
+};
@@ -6,6 +6,7 @@ struct Subscriber {
     std::string name;
     std::string phone;
     std::string type; // "data" or "voice"
+    std::string tech; // device technology ("2G".."5G"), empty if unspecified
     int messages;
     int assigned_channel; // -1 if not assigned
     bool dropped;
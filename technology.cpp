@@ -7,12 +7,22 @@
 bool is_voice(const std::string &t) { return t == "voice" || t == "Voice" || t == "VOICE"; }
 bool is_data(const std::string &t) { return t == "data" || t == "Data" || t == "DATA"; }
 
+int TwoG::max_messages(const std::string &type) const {
+    if (is_data(type)) return 5;
+    if (is_voice(type)) return 15;
+    return 0;
+}
+
+int ThreeG::max_messages(const std::string &type) const { (void)type; return 10; }
+int FourG::max_messages(const std::string &type) const { (void)type; return 10; }
+int FiveG::max_messages(const std::string &type) const { (void)type; return 10; }
+
 void TwoG::validate_usage(const std::string &type, int messages) const {
     if (is_data(type)) {
-        if (messages > 5) 
+        if (messages > max_messages(type)) 
             throw std::runtime_error("Error: 2G Data limit exceeded. Max 5 messages allowed.");
     } else if (is_voice(type)) {
-        if (messages > 15) 
+        if (messages > max_messages(type)) 
             throw std::runtime_error("Error: 2G Voice limit exceeded. Max 15 messages allowed.");
     } else {
         throw std::runtime_error("Error: Invalid 2G Type. Must be 'data' or 'voice'.");
@@ -23,18 +33,18 @@ void ThreeG::validate_usage(const std::string &type, int messages) const {
     // 3G/4G/5G use Packet Switching for everything.
     // Project constraints usually imply a fixed packet limit (e.g., 10)
     (void)type; 
-    if (messages > 10) 
+    if (messages > max_messages(type)) 
         throw std::runtime_error("Error: 3G Packet limit exceeded. Max 10 messages allowed.");
 }
 
 void FourG::validate_usage(const std::string &type, int messages) const {
     (void)type; 
-    if (messages > 10) 
+    if (messages > max_messages(type)) 
         throw std::runtime_error("Error: 4G Packet limit exceeded. Max 10 messages allowed.");
 }
 
 void FiveG::validate_usage(const std::string &type, int messages) const {
     (void)type; 
-    if (messages > 10) 
+    if (messages > max_messages(type)) 
         throw std::runtime_error("Error: 5G Packet limit exceeded. Max 10 messages allowed.");
 }
\ No newline at end of file
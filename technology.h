@@ -8,7 +8,12 @@ public:
     virtual int users_per_channel() const = 0;
     virtual int channel_bandwidth_khz() const = 0;
     virtual int channels_for_bandwidth(double bw_mhz) const = 0;
+    // MIMO limit: 2G/3G are fixed at 1 antenna
+    virtual int max_antennas() const { return 1; }
     
+    // Per-subscriber message limit for a traffic type, 0 if the type is not supported
+    virtual int max_messages(const std::string &type) const = 0;
+
     // STRICT VALIDATION: This function checks limits and throws an error if violated
     virtual void validate_usage(const std::string &type, int messages) const = 0;
 };
@@ -22,6 +27,7 @@ public:
         return static_cast<int>(bw_mhz*1000) / channel_bandwidth_khz(); 
     }
     // 2G Specific Rules: Max 5 Data, Max 15 Voice
+    int max_messages(const std::string &type) const override;
     void validate_usage(const std::string &type, int messages) const override;
 };
 
@@ -33,27 +39,32 @@ public:
     int channels_for_bandwidth(double bw_mhz) const override { 
         return static_cast<int>(bw_mhz*1000) / channel_bandwidth_khz(); 
     }
+    int max_messages(const std::string &type) const override;
     void validate_usage(const std::string &type, int messages) const override;
 };
 
 class FourG : public Technology {
 public:
     std::string name() const override { return "4G"; }
+    int max_antennas() const override { return 4; }
     int users_per_channel() const override { return 30; }
     int channel_bandwidth_khz() const override { return 10; }
     int channels_for_bandwidth(double bw_mhz) const override { 
         return static_cast<int>(bw_mhz*1000) / channel_bandwidth_khz(); 
     }
+    int max_messages(const std::string &type) const override;
     void validate_usage(const std::string &type, int messages) const override;
 };
 
 class FiveG : public Technology {
 public:
     std::string name() const override { return "5G"; }
+    int max_antennas() const override { return 16; }
     int users_per_channel() const override { return 30; }
     int channel_bandwidth_khz() const override { return 1000; }
     int channels_for_bandwidth(double bw_mhz) const override { 
         return static_cast<int>(bw_mhz*1000) / channel_bandwidth_khz(); 
     }
+    int max_messages(const std::string &type) const override;
     void validate_usage(const std::string &type, int messages) const override;
 };
\ No newline at end of file
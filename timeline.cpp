@@ -0,0 +1,99 @@
+#include "timeline.h"
+#include "json.h"
+#include "utils.h"
+
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+std::atomic<bool> Timeline::enabled_(false);
+
+namespace {
+
+struct TimelineEvent {
+    const char *name;
+    const char *cat;
+    const char *arg;
+    char ph;            // 'X' complete, 'i' instant, 'C' counter
+    int64_t ts;
+    int64_t dur;
+    long long value;
+};
+
+struct ThreadBuffer {
+    int tid;
+    std::string name;
+    std::vector<TimelineEvent> events;
+};
+
+// Buffers outlive their threads (UserDevice threads exit before export)
+std::mutex registry_mtx;
+std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+const auto epoch = std::chrono::steady_clock::now();
+
+ThreadBuffer &localBuffer(){
+    thread_local ThreadBuffer *tls = nullptr;
+    if (!tls){
+        auto b = std::make_unique<ThreadBuffer>();
+        b->events.reserve(4096);
+        std::lock_guard<std::mutex> lk(registry_mtx);
+        b->tid = (int)buffers.size() + 1;
+        tls = b.get();
+        buffers.push_back(std::move(b));
+    }
+    return *tls;
+}
+
+} // namespace
+
+void Timeline::enable(){ enabled_.store(true, std::memory_order_relaxed); }
+
+int64_t Timeline::nowUs(){
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - epoch).count();
+}
+
+void Timeline::complete(const char *name, const char *cat, int64_t start_us, int64_t dur_us){
+    localBuffer().events.push_back({name, cat, nullptr, 'X', start_us, dur_us, 0});
+}
+
+void Timeline::instant(const char *name, const char *cat, const char *arg, long long value){
+    localBuffer().events.push_back({name, cat, arg, 'i', nowUs(), 0, value});
+}
+
+void Timeline::counter(const char *name, long long value){
+    localBuffer().events.push_back({name, "counter", nullptr, 'C', nowUs(), 0, value});
+}
+
+void Timeline::nameThread(const std::string &name){
+    if (enabled()) localBuffer().name = name;
+}
+
+void Timeline::writeJson(const std::string &path){
+    std::ofstream f(path);
+    if (!f) throw InputError("Cannot write timeline file: " + path);
+
+    std::lock_guard<std::mutex> lk(registry_mtx);
+    f << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    bool first = true;
+    auto sep = [&](){ if (!first) f << ",\n"; first = false; };
+
+    for (const auto &b : buffers){
+        if (!b->name.empty()){
+            sep();
+            f << "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":" << b->tid
+              << ",\"args\":{\"name\":\"" << jsonEscape(b->name) << "\"}}";
+        }
+        for (const auto &e : b->events){
+            sep();
+            f << "{\"ph\":\"" << e.ph << "\",\"name\":\"" << e.name << "\",\"cat\":\"" << e.cat
+              << "\",\"pid\":1,\"tid\":" << b->tid << ",\"ts\":" << e.ts;
+            if (e.ph == 'X') f << ",\"dur\":" << e.dur;
+            else if (e.ph == 'i') f << ",\"s\":\"t\",\"args\":{\"" << e.arg << "\":" << e.value << "}";
+            else if (e.ph == 'C') f << ",\"args\":{\"value\":" << e.value << "}";
+            f << "}";
+        }
+    }
+    f << "\n]}\n";
+}
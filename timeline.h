@@ -0,0 +1,62 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+// Low-overhead instrumentation exported as Chrome trace-event JSON
+// (open in chrome://tracing or ui.perfetto.dev). Events go to per-thread
+// buffers, so recording never takes a lock. When disabled every trace point
+// costs one relaxed atomic load; build with -DSIM_NO_TIMELINE to compile them out.
+//
+// Names and categories must be string literals (only the pointer is stored).
+class Timeline {
+public:
+    static void enable();
+    static bool enabled() { return enabled_.load(std::memory_order_relaxed); }
+
+    static int64_t nowUs();
+    static void complete(const char *name, const char *cat, int64_t start_us, int64_t dur_us);
+    static void instant(const char *name, const char *cat, const char *arg, long long value);
+    static void counter(const char *name, long long value);
+    static void nameThread(const std::string &name);
+
+    // Call once recording threads have been joined.
+    static void writeJson(const std::string &path);
+
+private:
+    static std::atomic<bool> enabled_;
+};
+
+class TimelineScope {
+public:
+    TimelineScope(const char *name, const char *cat)
+    : name_(name), cat_(cat), start_(Timeline::enabled() ? Timeline::nowUs() : -1) {}
+    ~TimelineScope(){
+        if (start_ >= 0) Timeline::complete(name_, cat_, start_, Timeline::nowUs() - start_);
+    }
+    TimelineScope(const TimelineScope&) = delete;
+    TimelineScope &operator=(const TimelineScope&) = delete;
+
+private:
+    const char *name_;
+    const char *cat_;
+    int64_t start_;
+};
+
+#ifdef SIM_NO_TIMELINE
+#define TIMELINE_SCOPE(name, cat) ((void)0)
+#define TIMELINE_INSTANT(name, cat, arg, value) ((void)0)
+#define TIMELINE_COUNTER(name, value) ((void)0)
+#define TIMELINE_NAME_THREAD(name) ((void)0)
+#else
+#define TIMELINE_CONCAT2(a, b) a##b
+#define TIMELINE_CONCAT(a, b) TIMELINE_CONCAT2(a, b)
+#define TIMELINE_SCOPE(name, cat) TimelineScope TIMELINE_CONCAT(timeline_scope_, __LINE__)(name, cat)
+#define TIMELINE_INSTANT(name, cat, arg, value) \
+    do { if (Timeline::enabled()) Timeline::instant(name, cat, arg, value); } while (0)
+#define TIMELINE_COUNTER(name, value) \
+    do { if (Timeline::enabled()) Timeline::counter(name, value); } while (0)
+// `name` may build a string; it is only evaluated while recording
+#define TIMELINE_NAME_THREAD(name) \
+    do { if (Timeline::enabled()) Timeline::nameThread(name); } while (0)
+#endif
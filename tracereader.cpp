@@ -0,0 +1,137 @@
+#include "tracereader.h"
+#include "utils.h"
+
+#include <cstring>
+#include <cctype>
+#include <climits>
+#include <cstdint>
+
+static const char TRACE_MAGIC[4] = {'C','T','R','C'};
+static const uint8_t TRACE_VERSION = 1;
+static const size_t TRACE_BUF_SIZE = 64 * 1024;
+
+TraceReader::TraceReader(const std::string &path)
+: path_(path), in_(path, std::ios::binary), binary_(false),
+  buf_(TRACE_BUF_SIZE), pos_(0), len_(0), last_ts_(0), events_(0), line_(0), seen_row_(false) {
+    if (!in_) throw InputError("Cannot open trace file: " + path);
+
+    char head[5] = {0};
+    in_.read(head, 5);
+    if (in_.gcount() == 5 && std::memcmp(head, TRACE_MAGIC, 4) == 0){
+        if ((uint8_t)head[4] != TRACE_VERSION)
+            throw InputError("Unsupported trace version in " + path);
+        binary_ = true;
+    } else {
+        in_.clear();
+        in_.seekg(0);
+    }
+}
+
+bool TraceReader::isBinary() const { return binary_; }
+long TraceReader::eventsRead() const { return events_; }
+
+bool TraceReader::next(TraceEvent &ev){
+    bool ok = binary_ ? nextBinary(ev) : nextCsv(ev);
+    if (!ok) return false;
+    if (ev.timestamp_ms < last_ts_)
+        throw InputError("Trace out of order at event " + std::to_string(events_ + 1) + " in " + path_);
+    last_ts_ = ev.timestamp_ms;
+    events_++;
+    return true;
+}
+
+bool TraceReader::nextCsv(TraceEvent &ev){
+    std::string line;
+    while (std::getline(in_, line)){
+        line_++;
+        line = trim(line);
+        if (line.empty() || line[0] == '#') continue;
+        auto comma = line.find(',');
+        if (comma == std::string::npos)
+            throw InputError("Malformed trace line " + std::to_string(line_) + ": " + line);
+        std::string ts = trim(line.substr(0, comma));
+        std::string rest = line.substr(comma + 1);
+        std::string uid = trim(rest.substr(0, rest.find(',')));
+
+        // The first non-comment row may be a header, recognised by a
+        // timestamp column that does not start like a number.
+        bool first = !seen_row_;
+        seen_row_ = true;
+        size_t d = (!ts.empty() && ts[0] == '-') ? 1 : 0;
+        if (first && !ts.empty() && (d >= ts.size() || !std::isdigit((unsigned char)ts[d]))) continue;
+        try {
+            size_t used = 0;
+            ev.timestamp_ms = std::stoll(ts, &used);
+            if (used != ts.size()) throw InputError("partial");
+        } catch (...) { throw InputError("Invalid timestamp on trace line " + std::to_string(line_) + ": " + ts); }
+        if (ev.timestamp_ms < 0)
+            throw InputError("Negative timestamp on trace line " + std::to_string(line_) + ": " + ts);
+        ev.user_id = to_int(uid);
+        return true;
+    }
+    return false;
+}
+
+bool TraceReader::fill(){
+    in_.read(buf_.data(), buf_.size());
+    len_ = (size_t)in_.gcount();
+    pos_ = 0;
+    return len_ > 0;
+}
+
+bool TraceReader::readVarint(uint64_t &v){
+    v = 0;
+    for (int shift = 0; shift < 64; shift += 7){
+        if (pos_ == len_ && !fill()){
+            if (shift == 0) return false; // clean end of stream
+            throw InputError("Truncated trace record in " + path_);
+        }
+        uint8_t b = (uint8_t)buf_[pos_++];
+        v |= (uint64_t)(b & 0x7f) << shift;
+        if (!(b & 0x80)) return true;
+    }
+    throw InputError("Corrupt varint in trace " + path_);
+}
+
+bool TraceReader::nextBinary(TraceEvent &ev){
+    uint64_t delta, uid;
+    if (!readVarint(delta)) return false;
+    if (!readVarint(uid)) throw InputError("Truncated trace record in " + path_);
+    if (delta > (uint64_t)(INT64_MAX - last_ts_))
+        throw InputError("Corrupt trace " + path_ + ": timestamp overflow at event " + std::to_string(events_ + 1));
+    if (uid > (uint64_t)INT_MAX)
+        throw InputError("Corrupt trace " + path_ + ": user id out of range at event " + std::to_string(events_ + 1));
+    ev.timestamp_ms = last_ts_ + (int64_t)delta;
+    ev.user_id = (int)uid;
+    return true;
+}
+
+// --- BINARY WRITER ---
+
+TraceWriter::TraceWriter(const std::string &path)
+: out_(path, std::ios::binary | std::ios::trunc), last_ts_(0) {
+    if (!out_) throw InputError("Cannot create trace file: " + path);
+    out_.write(TRACE_MAGIC, 4);
+    out_.put((char)TRACE_VERSION);
+}
+
+void TraceWriter::write(const TraceEvent &ev){
+    if (ev.timestamp_ms < last_ts_) throw InputError("Trace events must be in timestamp order");
+    if (ev.user_id < 0) throw InputError("Trace user id cannot be negative");
+    writeVarint((uint64_t)(ev.timestamp_ms - last_ts_));
+    writeVarint((uint64_t)ev.user_id);
+    last_ts_ = ev.timestamp_ms;
+}
+
+void TraceWriter::writeVarint(uint64_t v){
+    while (v >= 0x80){
+        out_.put((char)((v & 0x7f) | 0x80));
+        v >>= 7;
+    }
+    out_.put((char)v);
+}
+
+void TraceWriter::close(){
+    out_.flush();
+    out_.close();
+}
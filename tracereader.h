@@ -0,0 +1,55 @@
+#pragma once
+#include <string>
+#include <fstream>
+#include <vector>
+#include <cstdint>
+
+// One message sent by one subscriber at a point in time.
+struct TraceEvent {
+    int64_t timestamp_ms;
+    int user_id;
+};
+
+// Streams a timestamped message trace without loading it whole.
+// Two encodings are accepted, detected from the first bytes:
+//  - CSV: "timestamp_ms,user_id" per line (optional header, '#' comments)
+//  - Binary: "CTRC" + version, then varint (delta timestamp, user id) pairs
+// Events must be in non-decreasing timestamp order.
+class TraceReader {
+public:
+    explicit TraceReader(const std::string &path);
+    bool next(TraceEvent &ev);
+    bool isBinary() const;
+    long eventsRead() const;
+
+private:
+    bool nextCsv(TraceEvent &ev);
+    bool nextBinary(TraceEvent &ev);
+    bool readVarint(uint64_t &v);
+    bool fill();
+
+    std::string path_;
+    std::ifstream in_;
+    bool binary_;
+    std::vector<char> buf_;
+    size_t pos_;
+    size_t len_;
+    int64_t last_ts_;
+    long events_;
+    long line_;
+    bool seen_row_;  // a header is only allowed before the first row
+};
+
+// Writes the compact binary form read by TraceReader.
+class TraceWriter {
+public:
+    explicit TraceWriter(const std::string &path);
+    void write(const TraceEvent &ev);
+    void close();
+
+private:
+    void writeVarint(uint64_t v);
+
+    std::ofstream out_;
+    int64_t last_ts_;
+};
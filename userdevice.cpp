@@ -1,4 +1,5 @@
 #include "userdevice.h"
+#include "timeline.h"
 #include <chrono>
 #include <thread>
 
@@ -23,6 +24,8 @@ int UserDevice::id() const { return id_; }
 int UserDevice::messages() const { return messages_; }
 
 void UserDevice::run(){
+    TIMELINE_NAME_THREAD("UserDevice " + std::to_string(id_));
+    TIMELINE_SCOPE("device run", "device");
     for (int i = 0; i < messages_; ++i){
         // Randomize delay slightly for realism
         std::this_thread::sleep_for(std::chrono::milliseconds(delay_ms_ + (rand()%100)));
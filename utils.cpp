@@ -12,6 +12,25 @@ int to_int(const std::string &s) {
     } catch(...) { throw InputError("Invalid integer: "+s); }
 }
 
+long to_long(const std::string &s) {
+    try {
+        size_t idx;
+        long v = std::stol(s,&idx);
+        if (idx!=s.size()) throw InputError("Invalid integer: "+s);
+        return v;
+    } catch(...) { throw InputError("Invalid integer: "+s); }
+}
+
+uint64_t to_u64(const std::string &s) {
+    try {
+        if (s.empty() || !std::isdigit((unsigned char)s[0])) throw InputError("Invalid unsigned integer: "+s);
+        size_t idx;
+        unsigned long long v = std::stoull(s,&idx);
+        if (idx!=s.size()) throw InputError("Invalid unsigned integer: "+s);
+        return (uint64_t)v;
+    } catch(...) { throw InputError("Invalid unsigned integer: "+s); }
+}
+
 double to_double(const std::string &s) {
     try {
         size_t idx;
@@ -1,12 +1,15 @@
 #pragma once
 #include <string>
 #include <stdexcept>
+#include <cstdint>
 
 struct InputError : public std::runtime_error {
     using std::runtime_error::runtime_error;
 };
 
 int to_int(const std::string &s);
+long to_long(const std::string &s);
+uint64_t to_u64(const std::string &s); // rejects a sign, which stoull would wrap
 double to_double(const std::string &s);
 std::string trim(const std::string &s);
 